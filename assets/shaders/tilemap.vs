@@ -4,10 +4,11 @@ layout(location = 0) in vec3 pos;
 layout(location = 1) in vec4 color;
 
 uniform mat4 view;
+uniform bool invert;
 
 out vec4 varColor;
 
 void main() {
     gl_Position = view * vec4(pos, 1.0);
-    varColor = color;
+    varColor = invert ? vec4(1.0 - color.rgb, color.a) : color;
 }
@@ -0,0 +1,135 @@
+#version 410
+
+in vec2 varPosition;
+
+uniform usampler2D tiles;
+uniform vec2 mapSize;
+uniform int tileCount;
+uniform int layer;
+
+uniform vec4 wallColor;
+uniform vec4 spikeColor;
+uniform vec4 goalColor;
+uniform vec4 defaultColor;
+
+out vec4 color;
+
+// ids must match the order in Tiles::init
+const uint WALL = 1u;
+const uint SPIKES_LEFT = 2u;
+const uint SPIKES_RIGHT = 3u;
+const uint SPIKES_UP = 4u;
+const uint SPIKES_DOWN = 5u;
+const uint GOAL_LEFT = 7u;
+const uint GOAL_RIGHT = 8u;
+const uint GOAL_UP = 9u;
+const uint GOAL_DOWN = 10u;
+const uint SPIKES = 11u;
+
+// same constants as in SpikeTile::addSpike
+const float s = 0.1;
+const float ss = 0.7;
+
+uint getTile(ivec2 p) {
+    ivec2 size = ivec2(mapSize);
+    if (p.x < 0 || p.y < 0 || p.x >= size.x || p.y >= size.y) {
+        return 255u;
+    }
+    return texelFetch(tiles, p, 0).r;
+}
+
+bool isAir(ivec2 p) {
+    uint id = getTile(p);
+    return id == 0u || id >= uint(tileCount);
+}
+
+float side(vec2 p, vec2 a, vec2 b) {
+    return (p.x - b.x) * (a.y - b.y) - (a.x - b.x) * (p.y - b.y);
+}
+
+bool inTriangle(vec2 p, vec2 a, vec2 b, vec2 c) {
+    float d1 = side(p, a, b);
+    float d2 = side(p, b, c);
+    float d3 = side(p, c, a);
+    bool negative = d1 < 0.0 || d2 < 0.0 || d3 < 0.0;
+    bool positive = d1 > 0.0 || d2 > 0.0 || d3 > 0.0;
+    return !(negative && positive);
+}
+
+bool inRectangle(vec2 p, vec2 minimum, vec2 maximum) {
+    return all(greaterThanEqual(p, minimum)) && all(lessThanEqual(p, maximum));
+}
+
+// top left quarter of a spike tile, the other quarters are mirrored into it
+bool inQuarter(vec2 p, bool horizontal, bool vertical) {
+    if (horizontal && !vertical) {
+        return inTriangle(p, vec2(0.5 - s, 0.0), vec2(0.0, 0.25), vec2(0.5 - s, 0.5)) ||
+               inRectangle(p, vec2(0.5 - s, 0.0), vec2(0.5, 0.5));
+    } else if (!horizontal && vertical) {
+        return inTriangle(p, vec2(0.0, 0.5 - s), vec2(0.25, 0.0), vec2(0.5, 0.5 - s)) ||
+               inRectangle(p, vec2(0.0, 0.5 - s), vec2(0.5, 0.5));
+    } else if (horizontal && vertical) {
+        return inTriangle(p, vec2(0.0, 0.0), vec2(ss, 0.5 - s), vec2(0.5 - s, ss));
+    }
+    return inRectangle(p, vec2(0.0), vec2(0.5));
+}
+
+bool inSpike(vec2 p, bool left, bool right, bool up, bool down) {
+    return inQuarter(p, left, up) || inQuarter(vec2(1.0 - p.x, p.y), right, up) ||
+           inQuarter(vec2(p.x, 1.0 - p.y), left, down) || inQuarter(1.0 - p, right, down);
+}
+
+vec4 spike(vec2 p, bool left, bool right, bool up, bool down) {
+    if (!inSpike(p, left, right, up, down)) {
+        discard;
+    }
+    return spikeColor;
+}
+
+vec4 renderSolid(uint id, ivec2 tile, vec2 p) {
+    if (id == WALL) {
+        return wallColor;
+    } else if (id == SPIKES_LEFT) {
+        return spike(p, true, false, false, false);
+    } else if (id == SPIKES_RIGHT) {
+        return spike(p, false, true, false, false);
+    } else if (id == SPIKES_UP) {
+        return spike(p, false, false, true, false);
+    } else if (id == SPIKES_DOWN) {
+        return spike(p, false, false, false, true);
+    } else if (id == SPIKES) {
+        return spike(p, isAir(tile + ivec2(-1, 0)), isAir(tile + ivec2(1, 0)),
+                     isAir(tile + ivec2(0, -1)), isAir(tile + ivec2(0, 1)));
+    } else if (id >= uint(tileCount)) {
+        return defaultColor;
+    }
+    discard;
+    return vec4(0.0);
+}
+
+vec4 renderTransparent(uint id, vec2 p) {
+    float alpha;
+    if (id == GOAL_LEFT) {
+        alpha = p.x;
+    } else if (id == GOAL_RIGHT) {
+        alpha = 1.0 - p.x;
+    } else if (id == GOAL_UP) {
+        alpha = p.y;
+    } else if (id == GOAL_DOWN) {
+        alpha = 1.0 - p.y;
+    } else {
+        discard;
+    }
+    return vec4(goalColor.rgb, goalColor.a * alpha);
+}
+
+void main() {
+    ivec2 tile = clamp(ivec2(floor(varPosition)), ivec2(0), ivec2(mapSize) - 1);
+    vec2 p = varPosition - vec2(tile);
+    uint id = getTile(tile);
+    if (layer == 0) {
+        color = renderSolid(id, tile, p);
+    } else {
+        color = renderTransparent(id, p);
+    }
+}
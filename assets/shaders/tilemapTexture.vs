@@ -0,0 +1,13 @@
+#version 410
+
+layout(location = 0) in vec3 pos;
+
+uniform mat4 view;
+uniform float depth;
+
+out vec2 varPosition;
+
+void main() {
+    gl_Position = view * vec4(pos.xy, depth, 1.0);
+    varPosition = pos.xy;
+}
@@ -0,0 +1,69 @@
+#include "Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "Utils.h"
+
+Arena::Arena(size_t blockSize)
+    : blockSize(blockSize), currentBlock(0), used(0), allocations(0), allocatedBytes(0),
+      liveAllocations(0) {
+}
+
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    allocations++;
+    allocatedBytes += size;
+    liveAllocations++;
+    while (currentBlock < blocks.size()) {
+        Block& block = blocks[currentBlock];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        size_t start = alignUp(base + used, alignment) - base;
+        if (start + size <= block.size) {
+            used = start + size;
+            return block.data.get() + start;
+        }
+        currentBlock++;
+        used = 0;
+    }
+    // blocks are kept over resets, big allocations get a block of their own
+    size_t newSize = std::max(blockSize, size + alignment);
+    blocks.push_back({std::make_unique<char[]>(newSize), newSize});
+    currentBlock = blocks.size() - 1;
+    uintptr_t base = reinterpret_cast<uintptr_t>(blocks.back().data.get());
+    used = alignUp(base, alignment) - base + size;
+    return blocks.back().data.get() + (used - size);
+}
+
+void Arena::deallocate(void* p, size_t size) {
+    (void)p;
+    (void)size;
+    liveAllocations--;
+}
+
+bool Arena::reset() {
+    if (liveAllocations > 0) {
+        Utils::printError("cannot reset arena with %zu live allocations\n", liveAllocations);
+        return true;
+    }
+    currentBlock = 0;
+    used = 0;
+    allocations = 0;
+    allocatedBytes = 0;
+    return false;
+}
+
+size_t Arena::getAllocations() const {
+    return allocations;
+}
+
+size_t Arena::getAllocatedBytes() const {
+    return allocatedBytes;
+}
+
+size_t Arena::getLiveAllocations() const {
+    return liveAllocations;
+}
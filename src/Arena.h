@@ -0,0 +1,80 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "NonCopyable.h"
+
+// bump allocator, all memory is given back at once by reset
+class Arena final : private NonCopyable {
+  public:
+    Arena(size_t blockSize = 1 << 16);
+
+    void* allocate(size_t size, size_t alignment);
+    // memory is only reused after reset, this just tracks the live allocations
+    void deallocate(void* p, size_t size);
+    // returns true and keeps the memory if allocations are still alive
+    bool reset();
+
+    size_t getAllocations() const;
+    size_t getAllocatedBytes() const;
+    size_t getLiveAllocations() const;
+
+  private:
+    struct Block final {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    size_t blockSize;
+    std::vector<Block> blocks;
+    size_t currentBlock;
+    size_t used;
+    size_t allocations;
+    size_t allocatedBytes;
+    size_t liveAllocations;
+};
+
+// allocates from the arena if there is one and from the heap otherwise
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    Arena* arena;
+
+    ArenaAllocator(Arena* arena = nullptr) noexcept : arena(arena) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {
+    }
+
+    T* allocate(size_t n) {
+        if (arena == nullptr) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        if (arena == nullptr) {
+            std::allocator<T>().deallocate(p, n);
+        } else {
+            arena->deallocate(p, n * sizeof(T));
+        }
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return arena != other.arena;
+    }
+};
+
+#endif
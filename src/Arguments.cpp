@@ -3,4 +3,11 @@
 bool Arguments::muted = false;
 bool Arguments::vsync = true;
 bool Arguments::skipAnim = false;
-int Arguments::samples = 4;
\ No newline at end of file
+int Arguments::samples = 4;
+bool Arguments::tileTexture = false;
+int Arguments::maxFps = 0;
+bool Arguments::renderOnTick = false;
+bool Arguments::threaded = false;
+const char* Arguments::traceFile = nullptr;
+const char* Arguments::perfLog = "perf.log";
+int Arguments::audioBufferSize = 1024;
\ No newline at end of file
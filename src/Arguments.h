@@ -6,6 +6,13 @@ namespace Arguments {
     extern bool vsync;
     extern bool skipAnim;
     extern int samples;
+    extern bool tileTexture;
+    extern int maxFps;
+    extern bool renderOnTick;
+    extern bool threaded;
+    extern const char* traceFile;
+    extern const char* perfLog;
+    extern int audioBufferSize;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "AssetLoader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Utils.h"
+
+typedef int64_t Nanos;
+
+enum class State { WAITING, RUNNING, DONE, FAILED };
+
+struct LoadTask final {
+    const char* name;
+    AssetLoader::Task task;
+    std::vector<int> dependencies;
+    bool mainThread;
+    State state;
+    Nanos nanos;
+};
+
+static std::vector<LoadTask> tasks;
+static std::mutex mutex;
+static std::condition_variable changed;
+
+static Nanos getNanos() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static int addTask(const char* name, AssetLoader::Task task,
+                   std::initializer_list<int> dependencies, bool mainThread) {
+    tasks.push_back({name, task, dependencies, mainThread, State::WAITING, 0});
+    return static_cast<int>(tasks.size()) - 1;
+}
+
+int AssetLoader::addWorkerTask(const char* name, Task task,
+                               std::initializer_list<int> dependencies) {
+    return addTask(name, task, dependencies, false);
+}
+
+int AssetLoader::addMainTask(const char* name, Task task, std::initializer_list<int> dependencies) {
+    return addTask(name, task, dependencies, true);
+}
+
+static bool hasFailed() {
+    return std::any_of(tasks.begin(), tasks.end(),
+                       [](const LoadTask& t) { return t.state == State::FAILED; });
+}
+
+static bool isFinished() {
+    return hasFailed() || std::all_of(tasks.begin(), tasks.end(),
+                                      [](const LoadTask& t) { return t.state == State::DONE; });
+}
+
+// returns the first waiting task whose dependencies are done or -1
+static int findReadyTask(bool mainThread) {
+    for (size_t i = 0; i < tasks.size(); i++) {
+        const LoadTask& t = tasks[i];
+        if (t.state != State::WAITING || t.mainThread != mainThread) {
+            continue;
+        }
+        bool ready = std::all_of(t.dependencies.begin(), t.dependencies.end(),
+                                 [](int d) { return tasks[d].state == State::DONE; });
+        if (ready) {
+            return i;
+        }
+        if (mainThread) {
+            // main tasks keep their order
+            return -1;
+        }
+    }
+    return -1;
+}
+
+// runs ready tasks of the given kind until all tasks are finished or one failed
+static void runTasks(bool mainThread) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!isFinished()) {
+        int index = findReadyTask(mainThread);
+        if (index < 0) {
+            changed.wait(lock);
+            continue;
+        }
+        tasks[index].state = State::RUNNING;
+        AssetLoader::Task task = tasks[index].task;
+        lock.unlock();
+        Nanos start = getNanos();
+        bool failed = task();
+        Nanos nanos = getNanos() - start;
+        lock.lock();
+        tasks[index].nanos = nanos;
+        tasks[index].state = failed ? State::FAILED : State::DONE;
+        changed.notify_all();
+    }
+}
+
+bool AssetLoader::run() {
+    Nanos start = getNanos();
+    int workers = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1, 4);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; i++) {
+        threads.emplace_back(runTasks, false);
+    }
+    runTasks(true);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (const LoadTask& t : tasks) {
+        Utils::print("%-24s %s %7.2fms%s\n", t.name, t.mainThread ? "main  " : "worker",
+                     t.nanos / 1'000'000.0f, t.state == State::FAILED ? " (failed)" : "");
+    }
+    Utils::print("loading took %.2fms\n", (getNanos() - start) / 1'000'000.0f);
+    bool failed = hasFailed();
+    tasks.clear();
+    return failed;
+}
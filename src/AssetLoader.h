@@ -0,0 +1,16 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <initializer_list>
+
+// startup task graph, worker tasks must not touch GL or shared game state
+namespace AssetLoader {
+    typedef bool (*Task)();
+
+    int addWorkerTask(const char* name, Task task, std::initializer_list<int> dependencies = {});
+    int addMainTask(const char* name, Task task, std::initializer_list<int> dependencies = {});
+    // runs all tasks, main tasks run on the calling thread in the order they were added
+    bool run();
+}
+
+#endif
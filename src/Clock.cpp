@@ -1,19 +1,26 @@
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 #include "Clock.h"
 
-Clock::Clock() : index(0), last(getNanos()), sum(0) {
+Clock::Clock(Nanos budget) : index(0), last(0), sum(0), budget(budget) {
     time.fill(0);
+    resetStats();
 }
 
 Clock::Nanos Clock::update() {
-    index = (index + 1) & (LENGTH - 1);
     Nanos current = getNanos();
+    if (last == 0) {
+        last = current;
+        return 0;
+    }
+    index = (index + 1) & (LENGTH - 1);
     sum -= time[index];
     time[index] = current - last;
     sum += time[index];
     last = current;
+    addSample(time[index]);
     return time[index];
 }
 
@@ -21,8 +28,74 @@ float Clock::getUpdatesPerSecond() const {
     return (LENGTH * 1000000000.0f) / sum;
 }
 
+static int getBucket(int64_t micros, int subBits, int maxBits) {
+    micros = std::clamp(micros, int64_t(0), (int64_t(1) << maxBits) - 1);
+    if (micros < (1 << subBits)) {
+        return micros;
+    }
+    int msb = subBits;
+    while ((micros >> (msb + 1)) != 0) {
+        msb++;
+    }
+    int shift = msb - subBits;
+    return ((shift + 1) << subBits) + ((micros >> shift) & ((1 << subBits) - 1));
+}
+
+static int64_t getBucketMicros(int bucket, int subBits) {
+    int shift = (bucket >> subBits) - 1;
+    int64_t sub = bucket & ((1 << subBits) - 1);
+    if (shift < 0) {
+        return sub;
+    }
+    return ((int64_t(1) << subBits) + sub) << shift;
+}
+
+void Clock::addSample(Nanos nanos) {
+    buckets[getBucket(nanos / 1000, SUB_BITS, MAX_BITS)]++;
+    count++;
+    hitches += nanos > 2 * budget;
+    max = std::max(max, nanos);
+}
+
+Clock::Nanos Clock::getPercentile(float percentile) const {
+    uint32_t rank = static_cast<uint32_t>(count * percentile);
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen > rank) {
+            return std::min(getBucketMicros(i, SUB_BITS) * 1000, max);
+        }
+    }
+    return max;
+}
+
+Clock::Nanos Clock::getMax() const {
+    return max;
+}
+
+int Clock::getHitches() const {
+    return hitches;
+}
+
+Clock::Nanos Clock::getBudget() const {
+    return budget;
+}
+
+Clock::Nanos Clock::getSample(int age) const {
+    return time[(index - age) & (LENGTH - 1)];
+}
+
+void Clock::resetStats() {
+    buckets.fill(0);
+    count = 0;
+    hitches = 0;
+    max = 0;
+    // the update which caused the reset is usually a loading hitch
+    last = 0;
+}
+
 Clock::Nanos Clock::getNanos() const {
     return std::chrono::duration_cast<std::chrono::nanoseconds>(
                std::chrono::high_resolution_clock::now().time_since_epoch())
         .count();
-}
\ No newline at end of file
+}
@@ -6,22 +6,41 @@
 
 struct Clock final {
     typedef int64_t Nanos;
-
-  private:
     static constexpr int BITS = 7;
     static constexpr int LENGTH = 1 << BITS;
+
+  private:
+    // log histogram in microseconds with 16 linear steps per power of two
+    static constexpr int SUB_BITS = 4;
+    static constexpr int MAX_BITS = 24;
+    static constexpr int BUCKETS = (MAX_BITS - SUB_BITS + 2) << SUB_BITS;
+
     int index;
     Nanos last;
     Nanos sum;
     std::array<Nanos, LENGTH> time;
 
+    Nanos budget;
+    std::array<uint32_t, BUCKETS> buckets;
+    uint32_t count;
+    uint32_t hitches;
+    Nanos max;
+
   public:
-    Clock();
+    Clock(Nanos budget);
     Nanos update();
     float getUpdatesPerSecond() const;
 
+    Nanos getPercentile(float percentile) const;
+    Nanos getMax() const;
+    int getHitches() const;
+    Nanos getBudget() const;
+    Nanos getSample(int age) const;
+    void resetStats();
+
   private:
     Nanos getNanos() const;
+    void addSample(Nanos nanos);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -10,6 +11,7 @@
 
 #include "AbilityCutscene.h"
 #include "Arguments.h"
+#include "AssetLoader.h"
 #include "Game.h"
 #include "GoalCutscene.h"
 #include "Input.h"
@@ -20,9 +22,12 @@
 #include "Utils.h"
 #include "graphics/Buffer.h"
 #include "graphics/Font.h"
+#include "graphics/FramePacer.h"
+#include "graphics/GpuTimer.h"
 #include "graphics/RenderState.h"
 #include "graphics/TextureRenderer.h"
 #include "graphics/Window.h"
+#include "graphics/gl/Commands.h"
 #include "graphics/gl/Glew.h"
 #include "graphics/gl/Shader.h"
 #include "graphics/gl/VertexBuffer.h"
@@ -99,10 +104,12 @@ static void findLevels() {
 
 #ifndef NDEBUG
 static void logGlError(const char* msg) {
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        fprintf(stderr, "GL-Error in %s: %u\n", msg, error);
-    }
+    GL::Commands::add([msg] {
+        GLenum error = glGetError();
+        if (error != GL_NO_ERROR) {
+            fprintf(stderr, "GL-Error in %s: %u\n", msg, error);
+        }
+    });
 }
 #endif
 
@@ -116,7 +123,7 @@ void Game::setBackgroundParticleColor() {
 
 bool Game::init() {
     Tiles::init();
-    if (Tilemap::init(48, 27) || Objects::init()) {
+    if (Tilemap::init(48, 27) || Objects::init() || ObjectRenderer::init()) {
         return true;
     }
 #ifndef NDEBUG
@@ -124,9 +131,18 @@ bool Game::init() {
         return true;
     }
 #endif
-    if (RenderState::init() || ParticleRenderer::init() || Font::init() ||
-        TextureRenderer::init() || Player::init() || Savegame::init() || AbilityCutscene::init() ||
-        GoalCutscene::init()) {
+    int fontData = AssetLoader::addWorkerTask("font data", Font::load);
+    int abilityData = AssetLoader::addWorkerTask("ability texture data", TextureRenderer::load);
+    AssetLoader::addWorkerTask("sounds", SoundManager::loadSounds);
+    AssetLoader::addMainTask("render state", RenderState::init);
+    AssetLoader::addMainTask("particle renderer", ParticleRenderer::init);
+    AssetLoader::addMainTask("font", Font::init, {fontData});
+    AssetLoader::addMainTask("texture renderer", TextureRenderer::init, {abilityData});
+    AssetLoader::addMainTask("player", Player::init);
+    AssetLoader::addMainTask("savegame", Savegame::init);
+    AssetLoader::addMainTask("ability cutscene", AbilityCutscene::init);
+    AssetLoader::addMainTask("goal cutscene", GoalCutscene::init);
+    if (AssetLoader::run()) {
         return true;
     }
     GoalTile::init();
@@ -137,11 +153,10 @@ bool Game::init() {
     backgroundParticles =
         Objects::instantiateObject<ParticleSystem>("assets/particlesystems/background.cmob");
     backgroundParticles->destroyOnLevelLoad = false;
+    backgroundParticles->priority = ParticlePriority::AMBIENT;
     setBackgroundParticleColor();
     backgroundParticles->play();
-    for (int i = 0; i < 500; i++) {
-        backgroundParticles->lateTick();
-    }
+    backgroundParticles->warmStart(500);
 
     titleEffectParticles = Objects::instantiateObject<ParticleSystem>(
         "assets/particlesystems/titleeffect.cmob", Vector(24.f, 23.f));
@@ -168,6 +183,9 @@ static void onTileLoad() {
 }
 
 static bool loadLevel(const char* name) {
+#ifdef PROFILER
+    Profiler::resetStats();
+#endif
 #ifndef NDEBUG
     if (strcmp(name, "_autosave") != 0) {
         Utils::print("Creating autosave.\n", name);
@@ -191,10 +209,16 @@ static bool loadLevel(const char* name) {
         return true;
     }
     Objects::clear();
-    if (Objects::load(formattedObjectmapName)) {
+    // tiles like the goal create their particle systems in onLoad
+    Objects::beginLevelAllocations();
+    bool failed = Objects::load(formattedObjectmapName);
+    if (!failed) {
+        onTileLoad();
+    }
+    Objects::endLevelAllocations();
+    if (failed) {
         return true;
     }
-    onTileLoad();
 
     Game::setFade(254);
     Game::fadeIn(4);
@@ -257,10 +281,9 @@ bool Game::loadLevelSelect() {
     currentLevelIndex = -1;
     nextLevelIndex = -1;
 
-    for (auto& obj : Objects::getObjects()) {
+    for (LevelDoorObject* door : Objects::getLevelDoors()) {
         // Destroy doors of accessible levels
-        auto door = std::dynamic_pointer_cast<LevelDoorObject>(obj);
-        if (door != nullptr && door->data.type < Savegame::getCompletedLevels()) {
+        if (door->data.type < Savegame::getCompletedLevels()) {
             door->open();
         }
     }
@@ -338,7 +361,6 @@ void Game::switchWorld() {
     SoundManager::switchMusic();
 
     setBackgroundParticleColor();
-    ObjectRenderer::clearStaticBuffer();
 }
 
 static void playFakeSwitchAnimation() {
@@ -388,10 +410,10 @@ static void tickLevelSelect() {
 }
 
 void Game::tick() {
-#ifndef NDEBUG
+#ifdef PROFILER
     Profiler::tick();
-    Profiler::Timer tickTimer(Profiler::tickNanos);
 #endif
+    PROFILE_SCOPE("Tick");
     if (paused) {
         if (singleStep) {
             singleStep = false;
@@ -462,24 +484,20 @@ void Game::tick() {
                 worldSwitchBuffer = 0;
             }
         }
-#ifndef NDEBUG
         {
-            Profiler::Timer timer(Profiler::objectTickNanos);
+            PROFILE_SCOPE("Object Tick");
             Objects::tick();
         }
         {
-            Profiler::Timer timer(Profiler::playerTickNanos);
+            PROFILE_SCOPE("Player Tick");
             Player::tick();
         }
         {
-            Profiler::Timer timer(Profiler::objectLateTickNanos);
+            PROFILE_SCOPE("Object Late Tick");
+            ParticleBudget::beginTick();
             Objects::lateTick();
+            ParticleBudget::endTick();
         }
-#else
-        Objects::tick();
-        Player::tick();
-        Objects::lateTick();
-#endif
     }
 
     totalTicks++;
@@ -514,19 +532,48 @@ static void drawFpsDisplay() {
     Font::draw(Vector(00.0f, 2.6f), 0.6f, ColorUtils::RED, buffer);
     snprintf(buffer, 256, "Samples: %d", Arguments::samples);
     Font::draw(Vector(00.0f, 3.2f), 0.6f, ColorUtils::RED, buffer);
+    snprintf(buffer, 256, "Frame: %.1fms (avg %.1fms, max %.1fms)", FramePacer::getFrameMillis(),
+             FramePacer::getAverageFrameMillis(), FramePacer::getMaxFrameMillis());
+    Font::draw(Vector(00.0f, 3.8f), 0.6f, ColorUtils::RED, buffer);
+
+    const Clock* clocks[] = {&Profiler::getFrameClock(), &Profiler::getTickClock()};
+    const char* names[] = {"Frame", "Tick"};
+    for (int i = 0; i < 2; i++) {
+        const Clock& c = *clocks[i];
+        snprintf(buffer, 256, "%s: p50 %.1fms p95 %.1fms p99 %.1fms max %.1fms hitches %d",
+                 names[i], c.getPercentile(0.5f) / 1'000'000.0f,
+                 c.getPercentile(0.95f) / 1'000'000.0f, c.getPercentile(0.99f) / 1'000'000.0f,
+                 c.getMax() / 1'000'000.0f, c.getHitches());
+        Font::draw(Vector(00.0f, 4.4f + i * 0.6f), 0.6f, ColorUtils::RED, buffer);
+    }
+
+    // frame times of the last frames, the budget is at half a unit
+    const Clock& frames = Profiler::getFrameClock();
+    float budget = frames.getBudget();
+    for (int i = 0; i < Clock::LENGTH; i++) {
+        float height = std::min(frames.getSample(i) / budget, 4.0f) * 0.5f;
+        Color c = frames.getSample(i) > 2 * budget ? ColorUtils::RED : ColorUtils::GREEN;
+        ObjectRenderer::addRectangle(Vector((Clock::LENGTH - 1 - i) * 0.1f, 8.0f - height),
+                                     Vector(0.08f, height), c);
+    }
+    ObjectRenderer::addRectangle(Vector(0.0f, 7.5f), Vector(Clock::LENGTH * 0.1f, 0.02f),
+                                 ColorUtils::YELLOW);
+    ObjectRenderer::render(m);
 }
 #endif
 
 void Game::render(float lag) {
-#ifndef NDEBUG
+#ifdef PROFILER
     Profiler::render();
-    Profiler::Timer renderTimer(Profiler::renderNanos);
 #endif
+    PROFILE_SCOPE("Render");
     if (Menu::isActive()) {
         lag = 0.0f;
     }
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
+    GL::Commands::add([] {
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LEQUAL);
+    });
     RenderState::bindAndClearDefaultFramebuffer();
 #ifndef NDEBUG
     if (tilemapEditor) {
@@ -537,34 +584,43 @@ void Game::render(float lag) {
     RenderState::updatePlayerViewMatrix(lag);
     RenderState::prepareEffectFramebuffer();
 
-    Tilemap::renderBackground();
-    Player::render(lag);
+    {
+        PROFILE_GPU_PASS("Tilemap Background");
+        Tilemap::renderBackground();
+    }
+    {
+        PROFILE_GPU_PASS("Player");
+        Player::render(lag);
+    }
 
     RenderState::enableBlending();
-    Tilemap::render();
+    {
+        PROFILE_GPU_PASS("Tilemap");
+        Tilemap::render();
+    }
 
     ParticleRenderer::prepare();
-#ifndef NDEBUG
     {
-        Profiler::Timer timer(Profiler::objectRenderNanos);
+        PROFILE_SCOPE("Object Render");
+        PROFILE_GPU_PASS("Objects");
         Objects::render(lag);
     }
     {
-        Profiler::Timer timer(Profiler::objectTextRenderNanos);
+        PROFILE_SCOPE("Object Text Render");
+        PROFILE_GPU_PASS("Object Text");
         Objects::renderText(lag);
     }
     {
-        Profiler::Timer timer(Profiler::particleRenderNanos);
+        PROFILE_SCOPE("Particle Render");
+        PROFILE_GPU_PASS("Particles");
         ParticleRenderer::render();
     }
-#else
-    Objects::render(lag);
-    Objects::renderText(lag);
-    ParticleRenderer::render();
-#endif
-    Tilemap::renderForeground();
+    {
+        PROFILE_GPU_PASS("Tilemap Foreground");
+        Tilemap::renderForeground();
+    }
 
-    glDisable(GL_DEPTH_TEST);
+    GL::Commands::add([] { glDisable(GL_DEPTH_TEST); });
 
     if (getCurrentLevel() == -1) {
         Color c = Player::invertColors() ? ColorUtils::WHITE : ColorUtils::BLACK;
@@ -578,17 +634,20 @@ void Game::render(float lag) {
 
     if (isInTitleScreen) {
         RenderState::updateViewMatrix(lag);
-        glDisable(GL_DEPTH_TEST);
+        GL::Commands::add([] { glDisable(GL_DEPTH_TEST); });
         Menu::render(lag);
+        PROFILE_GPU_PASS("Effects");
         RenderState::renderTitleScreenEffects(lag);
     } else {
+        PROFILE_GPU_PASS("Effects");
         RenderState::renderEffects(lag);
     }
 
+    PROFILE_GPU_PASS("UI");
     RenderState::disableBlending();
     RenderState::updateViewMatrix(lag);
 
-    glDisable(GL_DEPTH_TEST);
+    GL::Commands::add([] { glDisable(GL_DEPTH_TEST); });
     RenderState::enableBlending();
     if (!isInTitleScreen) {
         TextureRenderer::render(lag);
@@ -775,7 +834,7 @@ void Game::renderImGui() {
 
     if (ImGui::CollapsingHeader("Objects")) {
         for (size_t i = 0; i < Objects::getObjects().size(); i++) {
-            auto object = Objects::getObjects()[i];
+            const auto& object = Objects::getObjects()[i];
 
             const char* destructionInfo = "";
             if (!object->destroyOnLevelLoad) {
@@ -799,11 +858,19 @@ void Game::renderImGui() {
 
             ImGui::PushID(header);
             if (ImGui::CollapsingHeader(header)) {
+                // the group forwards the edits of all its widgets
+                ImGui::BeginGroup();
                 ImGui::DragFloat2("Position", object->position.data());
                 ImGui::InputInt("Prototype ID (dangerous)", &object->prototypeId);
                 ImGui::Spacing();
 
                 object->renderImGui();
+                ImGui::EndGroup();
+                if (ImGui::IsItemEdited()) {
+                    // position, size and type may have changed
+                    Objects::markChanged();
+                    ObjectRenderer::clearStaticBuffer();
+                }
                 if (ImGui::Button("Destroy")) {
                     object->destroy();
                 }
@@ -2,6 +2,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
 
 static Button buttons[(size_t)ButtonType::MAX];
 static float axes[(size_t)AxisType::MAX];
@@ -12,20 +13,61 @@ static bool joystickControlled = false;
 static SDL_GameController* controller = nullptr;
 static SDL_Haptic* controllerHaptic = nullptr;
 
-void Input::Internal::setButtonPressed(ButtonType type) {
-    auto& button = buttons[(size_t)type];
+struct ButtonEvent final {
+    ButtonType type;
+    bool pressed;
+    int64_t nanos;
+};
+static std::vector<ButtonEvent> events;
+static int64_t eventTime = 0;
+
+static void pressButton(Button& button) {
     button.pressed = true;
     button.pressedFirstFrame = true;
     button.pressedTicks = 0;
 }
 
-void Input::Internal::setButtonReleased(ButtonType type) {
-    auto& button = buttons[(size_t)type];
+static void releaseButton(Button& button) {
     button.pressed = false;
     button.pressedFirstFrame = false;
     button.pressedTicks = -1;
 }
 
+// applies the events which happened until the given time, each button changes at most once per
+// tick so that short presses are not lost
+static void applyEvents(int64_t nanos) {
+    bool changed[(size_t)ButtonType::MAX] = {};
+    size_t kept = 0;
+    for (const ButtonEvent& e : events) {
+        if (e.nanos > nanos || changed[(size_t)e.type]) {
+            events[kept++] = e;
+            continue;
+        }
+        auto& button = buttons[(size_t)e.type];
+        if (e.pressed == button.pressed) {
+            continue;
+        } else if (e.pressed) {
+            pressButton(button);
+        } else {
+            releaseButton(button);
+        }
+        changed[(size_t)e.type] = true;
+    }
+    events.resize(kept);
+}
+
+void Input::Internal::setEventTime(int64_t nanos) {
+    eventTime = nanos;
+}
+
+void Input::Internal::setButtonPressed(ButtonType type) {
+    events.push_back({type, true, eventTime});
+}
+
+void Input::Internal::setButtonReleased(ButtonType type) {
+    events.push_back({type, false, eventTime});
+}
+
 void Input::Internal::setJoystickFactor(float factor) {
     joystickFactor = factor;
 }
@@ -42,7 +84,8 @@ void Input::Internal::setAxis(AxisType type, float value) {
     axes[(size_t)type] = value;
 }
 
-void Input::Internal::update() {
+void Input::Internal::update(int64_t nanos) {
+    applyEvents(nanos);
     for (auto& button : buttons) {
         button.pressedFirstFrame = button.pressed && button.pressedTicks == 0;
         button.pressedTicks = button.pressed ? button.pressedTicks + 1 : 0;
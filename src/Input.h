@@ -3,6 +3,7 @@
 
 #include <SDL_gamecontroller.h>
 #include <SDL_haptic.h>
+#include <cstdint>
 #include <string>
 
 enum class ButtonType {
@@ -39,13 +40,14 @@ struct Button {
 
 namespace Input {
     namespace Internal {
+        void setEventTime(int64_t nanos);
         void setButtonPressed(ButtonType type);
         void setButtonReleased(ButtonType type);
         void setJoystickFactor(float factor);
         void setJoystickControlled(bool controlled);
         bool getJoystickControlled();
         void setAxis(AxisType type, float value);
-        void update();
+        void update(int64_t nanos);
     }
 
     Button& getButton(ButtonType type);
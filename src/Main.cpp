@@ -14,6 +14,20 @@ int main(int argc, char** args) {
             Arguments::vsync = false;
         } else if (strcmp(args[i], "--skip-anim") == 0) {
             Arguments::skipAnim = true;
+        } else if (strcmp(args[i], "--tile-texture") == 0) {
+            Arguments::tileTexture = true;
+        } else if (strcmp(args[i], "--fps") == 0 && i + 1 < argc) {
+            Arguments::maxFps = atoi(args[++i]);
+        } else if (strcmp(args[i], "--render-on-tick") == 0) {
+            Arguments::renderOnTick = true;
+        } else if (strcmp(args[i], "--threaded") == 0) {
+            Arguments::threaded = true;
+        } else if (strcmp(args[i], "--trace") == 0 && i + 1 < argc) {
+            Arguments::traceFile = args[++i];
+        } else if (strcmp(args[i], "--perf-log") == 0 && i + 1 < argc) {
+            Arguments::perfLog = args[++i];
+        } else if (strcmp(args[i], "--audio-buffer") == 0 && i + 1 < argc) {
+            Arguments::audioBufferSize = atoi(args[++i]);
         } else if (parseIndex == 0) {
             int samples = atoi(args[i]);
             if (samples <= 0) {
@@ -0,0 +1,145 @@
+#include "PerfCounters.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+
+#include "Utils.h"
+
+static constexpr int FRAME_BUCKETS = 64;
+static constexpr int TICK_BUCKETS = 8;
+
+// frame values are summed up during a frame and accumulated in addFrame
+struct FrameValue final {
+    int64_t current = 0;
+    int64_t last = 0;
+    int64_t max = 0;
+    int64_t sum = 0;
+
+    void end() {
+        last = current;
+        max = std::max(max, current);
+        sum += current;
+        current = 0;
+    }
+};
+
+static int64_t frames = 0;
+static std::array<int64_t, FRAME_BUCKETS> frameMillis{};
+static std::array<int64_t, TICK_BUCKETS> ticksPerFrame{};
+static FrameValue drawCalls;
+static FrameValue uploadedVertices;
+static FrameValue liveObjects;
+static FrameValue tickedObjects;
+static FrameValue liveParticles;
+
+// ticks can come from the simulation thread
+static std::atomic<int64_t> ticks{0};
+static std::atomic<int> frameTicks{0};
+static std::atomic<int64_t> skippedTicks{0};
+static std::atomic<int> frameTickedObjects{0};
+static std::atomic<int64_t> totalTickedObjects{0};
+static std::atomic<int64_t> totalObjectSlots{0};
+static std::atomic<int64_t> particleBudgetHits{0};
+static std::atomic<int64_t> particleDegradations{0};
+
+void PerfCounters::addFrame(Nanos frameNanos) {
+    frames++;
+    frameMillis[std::clamp(frameNanos / 1'000'000, Nanos(0), Nanos(FRAME_BUCKETS - 1))]++;
+    int tickCount = frameTicks.exchange(0, std::memory_order_relaxed);
+    ticksPerFrame[std::min(tickCount, TICK_BUCKETS - 1)]++;
+    drawCalls.end();
+    uploadedVertices.end();
+    liveObjects.end();
+    tickedObjects.current = frameTickedObjects.exchange(0, std::memory_order_relaxed);
+    tickedObjects.end();
+    liveParticles.end();
+}
+
+void PerfCounters::addTick() {
+    ticks.fetch_add(1, std::memory_order_relaxed);
+    frameTicks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfCounters::addSkippedTicks(int ticks) {
+    skippedTicks.fetch_add(ticks, std::memory_order_relaxed);
+}
+
+void PerfCounters::addDrawCall() {
+    drawCalls.current++;
+}
+
+void PerfCounters::addUploadedVertices(int vertices) {
+    uploadedVertices.current += vertices;
+}
+
+void PerfCounters::setLiveObjects(int objects) {
+    liveObjects.current = objects;
+}
+
+void PerfCounters::addTickedObjects(int ticked, int total) {
+    frameTickedObjects.fetch_add(ticked, std::memory_order_relaxed);
+    totalTickedObjects.fetch_add(ticked, std::memory_order_relaxed);
+    totalObjectSlots.fetch_add(total, std::memory_order_relaxed);
+}
+
+void PerfCounters::addLiveParticles(int particles) {
+    liveParticles.current += particles;
+}
+
+void PerfCounters::addParticleBudgetHit() {
+    particleBudgetHits.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfCounters::addParticleDegradation() {
+    particleDegradations.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void writeFrameValue(FILE* file, const char* name, const FrameValue& value) {
+    fprintf(file, "%s per frame: last %lld, avg %.1f, max %lld\n", name,
+            static_cast<long long>(value.last),
+            frames > 0 ? static_cast<double>(value.sum) / frames : 0.0,
+            static_cast<long long>(value.max));
+}
+
+bool PerfCounters::write(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        Utils::printError("cannot open perf log '%s'\n", path);
+        return true;
+    }
+    fprintf(file, "frames: %lld\n", static_cast<long long>(frames));
+    fprintf(file, "ticks: %lld\n", static_cast<long long>(ticks.load()));
+    fprintf(file, "skipped ticks: %lld\n", static_cast<long long>(skippedTicks.load()));
+    writeFrameValue(file, "draw calls", drawCalls);
+    writeFrameValue(file, "uploaded vertices", uploadedVertices);
+    writeFrameValue(file, "live objects", liveObjects);
+    writeFrameValue(file, "ticked objects", tickedObjects);
+    int64_t slots = totalObjectSlots.load();
+    fprintf(file, "ticked object ratio: %.1f%%\n",
+            slots > 0 ? 100.0 * totalTickedObjects.load() / slots : 100.0);
+    writeFrameValue(file, "live particles", liveParticles);
+    fprintf(file, "particle budget hits: %lld\n",
+            static_cast<long long>(particleBudgetHits.load()));
+    fprintf(file, "particle degradations: %lld\n",
+            static_cast<long long>(particleDegradations.load()));
+
+    fputs("ticks per frame:\n", file);
+    for (int i = 0; i < TICK_BUCKETS; i++) {
+        if (ticksPerFrame[i] > 0) {
+            fprintf(file, "  %d%s: %lld\n", i, i == TICK_BUCKETS - 1 ? "+" : "",
+                    static_cast<long long>(ticksPerFrame[i]));
+        }
+    }
+    fputs("frame time histogram:\n", file);
+    for (int i = 0; i < FRAME_BUCKETS; i++) {
+        if (frameMillis[i] > 0) {
+            fprintf(file, "  %2d%sms: %lld\n", i, i == FRAME_BUCKETS - 1 ? "+" : "",
+                    static_cast<long long>(frameMillis[i]));
+        }
+    }
+    fclose(file);
+    Utils::print("wrote perf log to '%s'\n", path);
+    return false;
+}
@@ -0,0 +1,24 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+
+// cheap counters which are also collected in release builds
+namespace PerfCounters {
+    typedef int64_t Nanos;
+
+    void addFrame(Nanos frameNanos);
+    void addTick();
+    void addSkippedTicks(int ticks);
+    void addDrawCall();
+    void addUploadedVertices(int vertices);
+    void setLiveObjects(int objects);
+    void addTickedObjects(int ticked, int total);
+    void addLiveParticles(int particles);
+    void addParticleBudgetHit();
+    void addParticleDegradation();
+
+    bool write(const char* path);
+}
+
+#endif
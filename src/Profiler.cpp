@@ -1,14 +1,38 @@
 #include "Profiler.h"
 
-#include <iostream>
-
-#include "Clock.h"
-
-#ifndef NDEBUG
-static Clock tps;
-static Clock fps;
-
-static int timerTicks = 0;
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <imgui.h>
+#include <vector>
+
+#include "Utils.h"
+#include "graphics/GpuTimer.h"
+
+#ifdef PROFILER
+static constexpr int MAX_THREADS = 4;
+static constexpr uint64_t RING_SIZE = 1 << 15;
+
+struct Event final {
+    const char* name;
+    Profiler::Nanos start;
+    Profiler::Nanos end;
+    int depth;
+};
+
+// only the owning thread writes, readers validate their copy against the published count
+struct Ring final {
+    std::atomic<uint64_t> count{0};
+    Event events[RING_SIZE];
+};
+
+static Ring rings[MAX_THREADS];
+static std::atomic<int> threadCount{0};
+static thread_local int threadIndex = -1;
+static thread_local int depth = 0;
+
+static Clock tps(10'000'000);
+static Clock fps(1'000'000'000 / 60);
 
 static Profiler::Nanos getNanos() {
     return std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -16,70 +40,56 @@ static Profiler::Nanos getNanos() {
         .count();
 }
 
-static void tickTimer() {
-    timerTicks++;
-}
+static Profiler::Nanos startTime = getNanos();
 
-Profiler::Timer::Timer(Nanos& n) : n(n) {
-    n = -getNanos();
+static Ring* getRing() {
+    if (threadIndex < 0) {
+        threadIndex = threadCount.fetch_add(1);
+    }
+    return threadIndex < MAX_THREADS ? rings + threadIndex : nullptr;
 }
 
-Profiler::Timer::~Timer() {
-    n += getNanos();
+static int getThreadCount() {
+    return std::min(threadCount.load(), MAX_THREADS);
 }
 
-Profiler::Nanos Profiler::tickNanos = 0;
-Profiler::Nanos Profiler::objectTickNanos = 0;
-Profiler::Nanos Profiler::playerTickNanos = 0;
-Profiler::Nanos Profiler::objectLateTickNanos = 0;
-Profiler::Nanos Profiler::renderNanos = 0;
-Profiler::Nanos Profiler::objectRenderNanos = 0;
-Profiler::Nanos Profiler::objectTextRenderNanos = 0;
-Profiler::Nanos Profiler::particleRenderNanos = 0;
-Profiler::Nanos Profiler::postGameRenderNanos = 0;
-Profiler::Nanos Profiler::bufferSwapNanos = 0;
-Profiler::Nanos Profiler::eventPollNanos = 0;
-
-static void logNanos(const char* msg, Profiler::Nanos n) {
-    std::cout << msg << ": " << n / 1'000'000.0f << "ms\n";
+// appends the events of a thread which were not overwritten while copying
+static void collect(int thread, std::vector<Event>& out) {
+    Ring& ring = rings[thread];
+    uint64_t end = ring.count.load(std::memory_order_acquire);
+    uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+    size_t first = out.size();
+    for (uint64_t i = begin; i < end; i++) {
+        out.push_back(ring.events[i & (RING_SIZE - 1)]);
+    }
+    // the writer may already be filling the slot of the event at index after
+    uint64_t after = ring.count.load(std::memory_order_acquire);
+    if (after + 1 - begin > RING_SIZE) {
+        uint64_t lost = std::min(after + 1 - begin - RING_SIZE, end - begin);
+        out.erase(out.begin() + first, out.begin() + first + lost);
+    }
 }
 
-static void logTickNanos() {
-    return;
-    if (tps.getUpdatesPerSecond() > 98.0f || timerTicks < 500) {
-        return;
-    }
-    std::cout << "-------------------------------\n";
-    logNanos("Tick", Profiler::tickNanos);
-    logNanos("> Object Tick", Profiler::objectTickNanos);
-    logNanos("> Player Tick", Profiler::playerTickNanos);
-    logNanos("> Object Late Tick", Profiler::objectLateTickNanos);
+Profiler::Scope::Scope(const char* name) : name(name), start(getNanos()) {
+    depth++;
 }
 
-static void logRenderNanos() {
-    return;
-    if (fps.getUpdatesPerSecond() > 59.0f || timerTicks < 500) {
+Profiler::Scope::~Scope() {
+    depth--;
+    Ring* ring = getRing();
+    if (ring == nullptr) {
         return;
     }
-    std::cout << "-------------------------------\n";
-    logNanos("Render", Profiler::renderNanos);
-    logNanos("> Object Render", Profiler::objectRenderNanos);
-    logNanos("> Object Text Render", Profiler::objectTextRenderNanos);
-    logNanos("> Particle Render", Profiler::particleRenderNanos);
-    std::cout << "-------------------------------\n";
-    logNanos("Post Game Render", Profiler::postGameRenderNanos);
-    logNanos("Buffer Swap", Profiler::bufferSwapNanos);
-    logNanos("Event Poll", Profiler::eventPollNanos);
+    uint64_t index = ring->count.load(std::memory_order_relaxed);
+    ring->events[index & (RING_SIZE - 1)] = {name, start, getNanos(), depth};
+    ring->count.store(index + 1, std::memory_order_release);
 }
 
 void Profiler::tick() {
-    tickTimer();
-    logTickNanos();
     tps.update();
 }
 
 void Profiler::render() {
-    logRenderNanos();
     fps.update();
 }
 
@@ -91,4 +101,116 @@ float Profiler::getTPS() {
     return tps.getUpdatesPerSecond();
 }
 
+const Clock& Profiler::getFrameClock() {
+    return fps;
+}
+
+const Clock& Profiler::getTickClock() {
+    return tps;
+}
+
+void Profiler::resetStats() {
+    fps.resetStats();
+    tps.resetStats();
+}
+
+bool Profiler::writeTrace(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        Utils::printError("cannot open trace file '%s'\n", path);
+        return true;
+    }
+    fputs("{\"traceEvents\":[\n", file);
+    bool first = true;
+    std::vector<Event> events;
+    for (int thread = 0; thread < getThreadCount(); thread++) {
+        events.clear();
+        collect(thread, events);
+        for (const Event& e : events) {
+            fprintf(file,
+                    "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,"
+                    "\"dur\":%.3f}",
+                    first ? "" : ",\n", e.name, thread, (e.start - startTime) / 1000.0,
+                    (e.end - e.start) / 1000.0);
+            first = false;
+        }
+    }
+    fputs("\n]}\n", file);
+    fclose(file);
+    Utils::print("wrote trace to '%s'\n", path);
+    return false;
+}
+
+static ImU32 getScopeColor(const char* name) {
+    size_t hash = 0;
+    for (const char* c = name; *c != '\0'; c++) {
+        hash = hash * 31 + static_cast<unsigned char>(*c);
+    }
+    return ImColor::HSV((hash % 360) / 360.0f, 0.5f, 0.7f);
+}
+
+void Profiler::renderImGui() {
+    static bool paused = false;
+    static float rangeMillis = 33.0f;
+    static Nanos now = 0;
+    static std::vector<Event> events[MAX_THREADS];
+
+    if (!ImGui::Begin("Profiler")) {
+        ImGui::End();
+        return;
+    }
+    ImGui::Checkbox("Pause", &paused);
+    ImGui::SameLine();
+    if (ImGui::Button("Write trace")) {
+        writeTrace("trace.json");
+    }
+    ImGui::SliderFloat("Range (ms)", &rangeMillis, 1.0f, 200.0f);
+
+    int threads = getThreadCount();
+    if (!paused) {
+        now = getNanos();
+        for (int thread = 0; thread < threads; thread++) {
+            events[thread].clear();
+            collect(thread, events[thread]);
+        }
+    }
+
+    float range = rangeMillis * 1'000'000.0f;
+    float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+    float width = ImGui::GetContentRegionAvail().x;
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    for (int thread = 0; thread < threads; thread++) {
+        ImGui::Text("Thread %d", thread);
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        int maxDepth = 0;
+        for (const Event& e : events[thread]) {
+            if (now - e.end > range) {
+                continue;
+            }
+            maxDepth = std::max(maxDepth, e.depth);
+            float left = std::max(origin.x + width * (1.0f - (now - e.start) / range), origin.x);
+            float right = std::max(origin.x + width * (1.0f - (now - e.end) / range), left + 1.0f);
+            float top = origin.y + e.depth * rowHeight;
+            ImVec2 min(left, top);
+            ImVec2 max(right, top + rowHeight - 1.0f);
+            drawList->AddRectFilled(min, max, getScopeColor(e.name));
+            drawList->PushClipRect(min, max, true);
+            drawList->AddText(min, IM_COL32_WHITE, e.name);
+            drawList->PopClipRect();
+            if (ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s: %.3fms", e.name, (e.end - e.start) / 1'000'000.0f);
+            }
+        }
+        ImGui::Dummy(ImVec2(width, (maxDepth + 1) * rowHeight));
+    }
+
+    float gpuMillis = 0.0f;
+    for (int i = 0; i < GpuTimer::getPassCount(); i++) {
+        ImGui::Text("GPU %s: %.3fms", GpuTimer::getPassName(i), GpuTimer::getPassMillis(i));
+        gpuMillis += GpuTimer::getPassMillis(i);
+    }
+    ImGui::Text("GPU total: %.3fms", gpuMillis);
+    ImGui::End();
+}
+
 #endif
@@ -3,35 +3,45 @@
 
 #include <chrono>
 
-#ifndef NDEBUG
+#include "Clock.h"
+
+// scopes are always recorded in debug builds, release builds enable them with -Dprofiler=true
+#if !defined(NDEBUG) && !defined(PROFILER)
+#define PROFILER
+#endif
+
+#ifdef PROFILER
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+#ifdef PROFILER
 namespace Profiler {
     typedef int64_t Nanos;
 
     void tick();
     void render();
 
-    extern Nanos tickNanos;
-    extern Nanos objectTickNanos;
-    extern Nanos playerTickNanos;
-    extern Nanos objectLateTickNanos;
-    extern Nanos renderNanos;
-    extern Nanos objectRenderNanos;
-    extern Nanos objectTextRenderNanos;
-    extern Nanos particleRenderNanos;
-
-    extern Nanos postGameRenderNanos;
-    extern Nanos bufferSwapNanos;
-    extern Nanos eventPollNanos;
-
     float getFPS();
     float getTPS();
-
-    struct Timer final {
-        Nanos& n;
-        Timer(Nanos& n);
-        ~Timer();
+    const Clock& getFrameClock();
+    const Clock& getTickClock();
+    void resetStats();
+
+    void renderImGui();
+    bool writeTrace(const char* path);
+
+    // name must be a string literal or otherwise outlive the profiler
+    struct Scope final {
+        const char* name;
+        Nanos start;
+        Scope(const char* name);
+        ~Scope();
     };
 }
 #endif
 
-#endif
\ No newline at end of file
+#endif
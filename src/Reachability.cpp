@@ -0,0 +1,595 @@
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "Arguments.h"
+#include "GoalCutscene.h"
+#include "Input.h"
+#include "Savegame.h"
+#include "Utils.h"
+#include "objects/Objects.h"
+#include "player/Player.h"
+#include "tilemap/Tilemap.h"
+#include "tilemap/Tiles.h"
+
+// explores the quantized player and object states of a map with the real player physics and
+// object ticks to find the shortest way to a goal, it needs no window or render context
+//
+// the player and object state are globals, so each step of the breadth first search is split
+// across forked worker processes which own a copy of that state, the workers drop duplicate
+// successors of their part and the main process keeps the visited set of the whole search
+
+static constexpr int MAX_LEVEL_NAME_LENGTH = 128;
+
+static constexpr int HELD_LEFT = 1;
+static constexpr int HELD_RIGHT = 2;
+static constexpr int HELD_JUMP = 4;
+static constexpr int HELD_ABILITY = 8;
+
+static constexpr float POSITION_STEPS = 8.0f;
+static constexpr float VELOCITY_STEPS = 40.0f;
+
+static constexpr int EXIT_REACHABLE = 0;
+static constexpr int EXIT_ERROR = 1;
+static constexpr int EXIT_UNREACHABLE = 2;
+static constexpr int EXIT_INCONCLUSIVE = 3;
+
+struct Node final {
+    Player::State state;
+    std::vector<char> objects;
+    int held;
+};
+
+struct Key final {
+    int32_t x;
+    int32_t y;
+    uint32_t velocity;
+    uint32_t flags;
+    uint64_t objects;
+
+    bool operator==(const Key& other) const {
+        return x == other.x && y == other.y && velocity == other.velocity &&
+               flags == other.flags && objects == other.objects;
+    }
+};
+
+struct KeyHash final {
+    size_t operator()(const Key& key) const {
+        uint64_t hash = static_cast<uint32_t>(key.x);
+        hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(key.y);
+        hash = hash * 0x9E3779B97F4A7C15ull + key.velocity;
+        hash = hash * 0x9E3779B97F4A7C15ull + key.flags;
+        hash = hash * 0x9E3779B97F4A7C15ull + key.objects;
+        return static_cast<size_t>(hash ^ (hash >> 29));
+    }
+};
+
+// the successors of a part of the frontier
+struct Expansion final {
+    bool goal = false;
+    int goalTick = 0;
+    bool changed = false;
+    std::vector<Node> nodes;
+};
+
+static int stepTicks = 1;
+static size_t maxStates = 2'000'000;
+
+// FNV-1a over the object state
+static uint64_t hashObjects(const std::vector<char>& objects) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (char c : objects) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+static int quantize(float value, float steps) {
+    return static_cast<int>(std::lround(value * steps));
+}
+
+static Key getKey(const Node& node) {
+    const Player::State& s = node.state;
+    Key key;
+    key.x = quantize(s.position.x, POSITION_STEPS);
+    key.y = quantize(s.position.y, POSITION_STEPS);
+    key.velocity = (static_cast<uint32_t>(quantize(s.velocity.x, VELOCITY_STEPS)) & 0xFFFF) |
+                   (static_cast<uint32_t>(quantize(s.velocity.y, VELOCITY_STEPS)) << 16);
+    uint32_t flags = static_cast<uint32_t>(s.abilities[0]);
+    flags = (flags << 3) | static_cast<uint32_t>(s.abilities[1]);
+    flags = (flags << 1) | s.worldType;
+    flags = (flags << 2) | std::min(s.jumpCount, 3);
+    flags = (flags << 1) | s.dashUseable;
+    flags = (flags << 3) | (s.dashTicks + 3) / 4;
+    flags = (flags << 1) | (s.dashCoolDown > 0);
+    flags = (flags << 1) | (s.fakeGrounded > 0);
+    flags = (flags << 1) | (s.jumpTicks > 0);
+    flags = (flags << 1) | (s.wallJumpTicks > 0);
+    flags = (flags << 3) | std::min(s.leftWallBuffer + s.rightWallBuffer, 7);
+    flags = (flags << 4) | node.held;
+    key.flags = flags;
+    key.objects = hashObjects(node.objects);
+    return key;
+}
+
+static void setButton(ButtonType type, bool pressed) {
+    Button& button = Input::getButton(type);
+    if (pressed && !button.pressed) {
+        button.pressedTicks = 0;
+    }
+    button.pressed = pressed;
+}
+
+// restores the buttons of the previous step as held so that they do not count as new presses
+static void restoreButtons(int held) {
+    const ButtonType types[] = {ButtonType::LEFT, ButtonType::RIGHT, ButtonType::JUMP,
+                                ButtonType::ABILITY};
+    for (int i = 0; i < 4; i++) {
+        Button& button = Input::getButton(types[i]);
+        button.pressed = (held & (1 << i)) != 0;
+        button.pressedTicks = button.pressed;
+        button.pressedFirstFrame = false;
+    }
+}
+
+static bool isOnGoal() {
+    Vector min = Player::getPosition();
+    Vector max = min + Player::getSize();
+    int minX = std::max(static_cast<int>(floorf(min.x)), 0);
+    int minY = std::max(static_cast<int>(floorf(min.y)), 0);
+    int maxX = std::min(static_cast<int>(floorf(max.x)), Tilemap::getWidth() - 1);
+    int maxY = std::min(static_cast<int>(floorf(max.y)), Tilemap::getHeight() - 1);
+    for (int x = minX; x <= maxX; x++) {
+        for (int y = minY; y <= maxY; y++) {
+            const Tile& tile = Tilemap::getTile(x, y);
+            if (tile == Tiles::GOAL_LEFT || tile == Tiles::GOAL_RIGHT ||
+                tile == Tiles::GOAL_UP || tile == Tiles::GOAL_DOWN) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+enum class StepResult { ALIVE, DEAD, GOAL, CHANGED };
+
+// simulates one step from the node with the given buttons, returns the tick of the goal in
+// goalTick
+static StepResult simulate(const Node& node, int held, bool switchWorld, Node& out,
+                           int& goalTick) {
+    size_t objects = Objects::getObjects().size();
+    Player::loadState(node.state);
+    Objects::loadState(node.objects);
+    restoreButtons(node.held);
+    setButton(ButtonType::LEFT, held & HELD_LEFT);
+    setButton(ButtonType::RIGHT, held & HELD_RIGHT);
+    setButton(ButtonType::JUMP, held & HELD_JUMP);
+    setButton(ButtonType::ABILITY, held & HELD_ABILITY);
+    if (switchWorld && !Player::isCollidingInAnyWorld()) {
+        Player::toggleWorld();
+    }
+    for (int tick = 0; tick < stepTicks; tick++) {
+        Input::Internal::update(0);
+        // keys reach their doors and doors open in the object tick like in Game::tick
+        Objects::tick();
+        Player::tick();
+        if (Objects::getObjects().size() != objects) {
+            // the saved object states only match as long as no object is added or removed
+            return StepResult::CHANGED;
+        }
+        if (Player::isDead()) {
+            return StepResult::DEAD;
+        }
+        if (isOnGoal()) {
+            goalTick = tick + 1;
+            return StepResult::GOAL;
+        }
+    }
+    Player::saveState(out.state);
+    Objects::saveState(out.objects);
+    out.held = held;
+    return StepResult::ALIVE;
+}
+
+static bool hasDoors() {
+    for (const auto& o : Objects::getObjects()) {
+        if (o->getDoorType() >= 0 || o->getKeyType() >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// expands the nodes in [begin, end) with all inputs, returns early when objects were added or
+// removed
+static void expand(const std::vector<Node>& nodes, size_t begin, size_t end, Expansion& out) {
+    std::unordered_set<Key, KeyHash> seen;
+    for (size_t i = begin; i < end; i++) {
+        const Node& node = nodes[i];
+        Player::loadState(node.state);
+        bool hasAbility = Player::getAbility() != Ability::NONE;
+        for (int held = 0; held < 16; held++) {
+            if ((held & (HELD_LEFT | HELD_RIGHT)) == (HELD_LEFT | HELD_RIGHT) ||
+                ((held & HELD_ABILITY) != 0 && !hasAbility)) {
+                continue;
+            }
+            for (int switchWorld = 0; switchWorld < 2; switchWorld++) {
+                Node next;
+                int goalTick = 0;
+                StepResult step = simulate(node, held, switchWorld, next, goalTick);
+                if (step == StepResult::GOAL) {
+                    // the rest of the step still runs for the earliest goal tick
+                    if (!out.goal || goalTick < out.goalTick) {
+                        out.goal = true;
+                        out.goalTick = goalTick;
+                    }
+                } else if (step == StepResult::CHANGED) {
+                    out.changed = true;
+                    return;
+                } else if (step == StepResult::ALIVE && seen.insert(getKey(next)).second) {
+                    out.nodes.push_back(std::move(next));
+                }
+            }
+        }
+    }
+}
+
+static void writeNodes(std::vector<char>& message, const Node* nodes, size_t count) {
+    saveStateValue(message, static_cast<uint32_t>(count));
+    for (size_t i = 0; i < count; i++) {
+        saveStateValue(message, nodes[i].state);
+        saveStateValue(message, nodes[i].held);
+        saveStateValue(message, static_cast<uint32_t>(nodes[i].objects.size()));
+        message.insert(message.end(), nodes[i].objects.begin(), nodes[i].objects.end());
+    }
+}
+
+static void readNodes(const char*& message, std::vector<Node>& nodes) {
+    uint32_t count = 0;
+    loadStateValue(message, count);
+    nodes.resize(count);
+    for (Node& node : nodes) {
+        uint32_t objects = 0;
+        loadStateValue(message, node.state);
+        loadStateValue(message, node.held);
+        loadStateValue(message, objects);
+        node.objects.assign(message, message + objects);
+        message += objects;
+    }
+}
+
+#ifndef _WIN32
+struct Worker final {
+    pid_t pid;
+    int requests;
+    int results;
+};
+static std::vector<Worker> workers;
+
+static bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written <= 0) {
+            return true;
+        }
+        data += written;
+        length -= written;
+    }
+    return false;
+}
+
+static bool readAll(int fd, char* data, size_t length) {
+    while (length > 0) {
+        ssize_t bytes = read(fd, data, length);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        } else if (bytes <= 0) {
+            return true;
+        }
+        data += bytes;
+        length -= bytes;
+    }
+    return false;
+}
+
+static bool sendMessage(int fd, const std::vector<char>& message) {
+    uint64_t length = message.size();
+    return writeAll(fd, reinterpret_cast<const char*>(&length), sizeof(length)) ||
+           writeAll(fd, message.data(), message.size());
+}
+
+static bool receiveMessage(int fd, std::vector<char>& message) {
+    uint64_t length = 0;
+    if (readAll(fd, reinterpret_cast<char*>(&length), sizeof(length))) {
+        return true;
+    }
+    message.resize(length);
+    return readAll(fd, message.data(), length);
+}
+
+// expands the parts of the frontier sent by the main process until its pipe is closed
+static void runWorker(int requests, int results) {
+    std::vector<char> message;
+    std::vector<Node> nodes;
+    while (!receiveMessage(requests, message)) {
+        const char* data = message.data();
+        readNodes(data, nodes);
+        Expansion expansion;
+        expand(nodes, 0, nodes.size(), expansion);
+        message.clear();
+        saveStateValue(message, expansion.goal);
+        saveStateValue(message, expansion.goalTick);
+        saveStateValue(message, expansion.changed);
+        writeNodes(message, expansion.nodes.data(), expansion.nodes.size());
+        if (sendMessage(results, message)) {
+            break;
+        }
+    }
+    _exit(0);
+}
+
+// forks after the level is loaded so that every worker starts with the same state
+static bool startWorkers(int count) {
+    // a dying worker should fail the search instead of killing it
+    signal(SIGPIPE, SIG_IGN);
+    fflush(stdout);
+    fflush(stderr);
+    for (int i = 0; i < count; i++) {
+        int requests[2];
+        int results[2];
+        if (pipe(requests) != 0) {
+            return true;
+        } else if (pipe(results) != 0) {
+            close(requests[0]);
+            close(requests[1]);
+            return true;
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(requests[0]);
+            close(requests[1]);
+            close(results[0]);
+            close(results[1]);
+            return true;
+        } else if (pid == 0) {
+            // earlier workers only see the end of their requests if the main process is the
+            // last one holding the pipes
+            for (const Worker& worker : workers) {
+                close(worker.requests);
+                close(worker.results);
+            }
+            close(requests[1]);
+            close(results[0]);
+            runWorker(requests[0], results[1]);
+        }
+        close(requests[0]);
+        close(results[1]);
+        workers.push_back({pid, requests[1], results[0]});
+    }
+    return false;
+}
+
+static void stopWorkers() {
+    for (const Worker& worker : workers) {
+        close(worker.requests);
+        close(worker.results);
+    }
+    for (const Worker& worker : workers) {
+        waitpid(worker.pid, nullptr, 0);
+    }
+    workers.clear();
+}
+#else
+// there is no fork on windows, the search runs in the main process
+static bool startWorkers(int) {
+    return false;
+}
+
+static void stopWorkers() {
+}
+#endif
+
+// returns true if a worker failed
+static bool expandFrontier(const std::vector<Node>& frontier,
+                           std::vector<Expansion>& expansions) {
+#ifndef _WIN32
+    if (!workers.empty()) {
+        size_t parts = std::min(workers.size(), frontier.size());
+        expansions.assign(parts, Expansion());
+        // every worker gets its part before any result is read so that all of them run at once
+        std::vector<char> message;
+        for (size_t i = 0; i < parts; i++) {
+            size_t begin = frontier.size() * i / parts;
+            size_t end = frontier.size() * (i + 1) / parts;
+            message.clear();
+            writeNodes(message, frontier.data() + begin, end - begin);
+            if (sendMessage(workers[i].requests, message)) {
+                return true;
+            }
+        }
+        for (size_t i = 0; i < parts; i++) {
+            if (receiveMessage(workers[i].results, message)) {
+                return true;
+            }
+            const char* data = message.data();
+            Expansion& expansion = expansions[i];
+            loadStateValue(data, expansion.goal);
+            loadStateValue(data, expansion.goalTick);
+            loadStateValue(data, expansion.changed);
+            readNodes(data, expansion.nodes);
+        }
+        return false;
+    }
+#endif
+    expansions.assign(1, Expansion());
+    expand(frontier, 0, frontier.size(), expansions[0]);
+    return false;
+}
+
+static int search(const char* name) {
+    auto start = std::chrono::steady_clock::now();
+    std::unordered_set<Key, KeyHash> visited;
+    std::vector<Node> frontier(1);
+    std::vector<Node> next;
+    std::vector<Expansion> expansions;
+    Player::saveState(frontier[0].state);
+    Objects::saveState(frontier[0].objects);
+    frontier[0].held = 0;
+    visited.insert(getKey(frontier[0]));
+
+    int ticks = 0;
+    int result = EXIT_UNREACHABLE;
+    int goalTick = 0;
+    bool changed = false;
+    while (!frontier.empty() && result == EXIT_UNREACHABLE) {
+        if (expandFrontier(frontier, expansions)) {
+            Utils::printError("a search worker failed\n");
+            return EXIT_ERROR;
+        }
+        next.clear();
+        for (Expansion& expansion : expansions) {
+            if (expansion.goal && (result != EXIT_REACHABLE || expansion.goalTick < goalTick)) {
+                result = EXIT_REACHABLE;
+                goalTick = expansion.goalTick;
+            }
+            changed = changed || expansion.changed;
+            for (Node& node : expansion.nodes) {
+                if (visited.insert(getKey(node)).second) {
+                    next.push_back(std::move(node));
+                }
+            }
+        }
+        if (result == EXIT_UNREACHABLE && (changed || visited.size() > maxStates)) {
+            result = EXIT_INCONCLUSIVE;
+        }
+        if (result == EXIT_UNREACHABLE) {
+            ticks += stepTicks;
+        }
+        std::swap(frontier, next);
+    }
+
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (result == EXIT_REACHABLE && stepTicks == 1) {
+        printf("%s: goal reached in %d ticks, %zu states in %.2fs\n", name, ticks + goalTick,
+               visited.size(), seconds);
+    } else if (result == EXIT_REACHABLE) {
+        // inputs only change every few ticks, a finer timing may reach the goal earlier
+        printf("%s: goal reached in at most %d ticks with %d tick steps, %zu states in %.2fs\n",
+               name, ticks + goalTick, stepTicks, visited.size(), seconds);
+    } else if (result == EXIT_UNREACHABLE && hasDoors()) {
+        // a missed door opening would make a beatable map look unbeatable
+        printf("%s: goal not found in a map with doors, %zu states in %.2fs\n", name,
+               visited.size(), seconds);
+        result = EXIT_INCONCLUSIVE;
+    } else if (result == EXIT_UNREACHABLE) {
+        printf("%s: goal unreachable, %zu states in %.2fs\n", name, visited.size(), seconds);
+    } else if (changed) {
+        printf("%s: objects were added or removed after %d ticks in %.2fs\n", name, ticks,
+               seconds);
+    } else {
+        printf("%s: state limit of %zu reached after %d ticks in %.2fs\n", name, maxStates, ticks,
+               seconds);
+    }
+    return result;
+}
+
+static bool init() {
+    Arguments::muted = true;
+    Arguments::skipAnim = true;
+    Tiles::init();
+    if (Objects::init()) {
+        return true;
+    }
+    Player::initParticles();
+    if (GoalCutscene::init()) {
+        return true;
+    }
+    // unlocking everything in memory keeps color objects from writing the savegame
+    Savegame::reset();
+    for (int i = 0; i < static_cast<int>(Ability::MAX); i++) {
+        Savegame::unlockAbilities(static_cast<Ability>(i), static_cast<Ability>(i));
+    }
+    return false;
+}
+
+static bool loadLevel(const char* name) {
+    char tilemapName[MAX_LEVEL_NAME_LENGTH];
+    char objectmapName[MAX_LEVEL_NAME_LENGTH];
+    if (snprintf(tilemapName, MAX_LEVEL_NAME_LENGTH, "assets/maps/%s.cmtm", name) >
+        MAX_LEVEL_NAME_LENGTH - 1) {
+        Utils::printError("The level file name is too long!\n");
+        return true;
+    }
+    snprintf(objectmapName, MAX_LEVEL_NAME_LENGTH, "assets/maps/%s.cmom", name);
+    if (Tilemap::load(tilemapName)) {
+        Utils::printError("cannot load tilemap '%s'\n", tilemapName);
+        return true;
+    }
+    Objects::clear();
+    Objects::beginLevelAllocations();
+    bool failed = Objects::load(objectmapName);
+    Objects::endLevelAllocations();
+    if (failed) {
+        Utils::printError("cannot load objects '%s'\n", objectmapName);
+        return true;
+    }
+    Player::setAllowedToMove(true);
+    Player::setGravityEnabled(true);
+    return false;
+}
+
+int main(int argc, char** args) {
+    const char* name = nullptr;
+    int jobs = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(args[i], "--step") == 0 && i + 1 < argc) {
+            stepTicks = std::max(atoi(args[++i]), 1);
+        } else if (strcmp(args[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = std::max(atoi(args[++i]), 1);
+        } else if (strcmp(args[i], "--max-states") == 0 && i + 1 < argc) {
+            maxStates = std::max(atoll(args[++i]), 1ll);
+        } else {
+            name = args[i];
+        }
+    }
+    if (name == nullptr) {
+        puts("usage: reachability [--step ticks] [--jobs workers] [--max-states states] "
+             "<map name>");
+        return EXIT_ERROR;
+    }
+
+#ifndef NDEBUG
+    if (!std::filesystem::exists("assets")) {
+        std::filesystem::current_path("..");
+    }
+#endif
+
+    if (init() || loadLevel(name)) {
+        return EXIT_ERROR;
+    }
+    if (jobs > 1 && startWorkers(jobs)) {
+        Utils::printError("cannot start the search workers\n");
+        stopWorkers();
+        return EXIT_ERROR;
+    }
+    int result = search(name);
+    stopWorkers();
+    return result;
+}
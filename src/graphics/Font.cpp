@@ -36,6 +36,7 @@ static int fontSize = 0;
 static int fontWidth = 0;
 static int fontHeight = 0;
 static int fontMaxOriginY = 0;
+static SDL_Surface* fontSurface = nullptr;
 std::array<Character, 128> characters;
 
 static float scale(float f) {
@@ -90,20 +91,13 @@ static bool readField(rapidjson::Value::ConstObject& o, const char* name, int& i
     return false;
 }
 
-bool Font::init() {
-    if (shader.compile({"assets/shaders/font.vs", "assets/shaders/font.fs"})) {
-        return true;
-    }
-    buffer.init(GL::VertexBuffer::Attributes().addVector2().addVector2().addRGBA());
-    texture.init();
+bool Font::load() {
     const char* path = "assets/font.png";
-    SDL_Surface* font = IMG_Load(path);
-    if (font == nullptr) {
+    fontSurface = IMG_Load(path);
+    if (fontSurface == nullptr) {
         Utils::printError("cannot load font file '%s': %s\n", path, IMG_GetError());
         return true;
     }
-    texture.setData(font->w, font->h, font->pixels);
-    SDL_FreeSurface(font);
 
     path = "assets/font.json";
     std::ifstream json;
@@ -152,6 +146,18 @@ bool Font::init() {
     return false;
 }
 
+bool Font::init() {
+    if (shader.compile({"assets/shaders/font.vs", "assets/shaders/font.fs"})) {
+        return true;
+    }
+    buffer.init(GL::VertexBuffer::Attributes().addVector2().addVector2().addRGBA());
+    texture.init();
+    texture.setData(fontSurface->w, fontSurface->h, fontSurface->pixels);
+    SDL_FreeSurface(fontSurface);
+    fontSurface = nullptr;
+    return false;
+}
+
 void Font::setZ(float zLayer) {
     shader.setFloat("zLayer", zLayer);
 }
@@ -197,14 +203,12 @@ void Font::draw(const Vector& pos, float size, Color color, const char* s) {
         data.add(maxX).add(minY).add(maxTexX).add(minTexY).add(color);
         data.add(minX).add(maxY).add(minTexX).add(maxTexY).add(color);
         data.add(maxX).add(maxY).add(maxTexX).add(maxTexY).add(color);
-        data.add(maxX).add(minY).add(maxTexX).add(minTexY).add(color);
-        data.add(minX).add(maxY).add(minTexX).add(maxTexY).add(color);
         x += size * scale(c.advance);
         index++;
     }
 
     buffer.setStreamData(data.getData(), data.getSize());
-    buffer.drawTriangles(6 * index);
+    buffer.drawQuads(index);
 }
 
 float Font::getWidth(float size, const char* s) {
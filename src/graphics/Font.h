@@ -6,6 +6,7 @@
 #include "math/Vector.h"
 
 namespace Font {
+    bool load();
     bool init();
     void prepare(float zLayer = 0.0f);
     void prepare(const Matrix& view, float zLayer = 0.0f);
@@ -0,0 +1,75 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include "Arguments.h"
+#include "PerfCounters.h"
+
+// sleeping is imprecise, the last part of a wait is spent spinning
+static constexpr FramePacer::Nanos SPIN_NANOS = 2'000'000;
+static constexpr int FRAME_SAMPLES = 128;
+
+static FramePacer::Nanos frameStart = 0;
+static FramePacer::Nanos nextFrame = 0;
+static std::array<FramePacer::Nanos, FRAME_SAMPLES> frameTimes{};
+static int frameIndex = 0;
+static FramePacer::Nanos frameTimeSum = 0;
+
+static FramePacer::Nanos getNanos() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void waitUntil(FramePacer::Nanos time) {
+    FramePacer::Nanos now = getNanos();
+    while (time - now > SPIN_NANOS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(time - now - SPIN_NANOS));
+        now = getNanos();
+    }
+    while (getNanos() < time) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::startFrame() {
+    frameStart = getNanos();
+}
+
+void FramePacer::endFrame() {
+    Nanos now = getNanos();
+    frameIndex = (frameIndex + 1) % FRAME_SAMPLES;
+    frameTimeSum -= frameTimes[frameIndex];
+    frameTimes[frameIndex] = now - frameStart;
+    frameTimeSum += frameTimes[frameIndex];
+    PerfCounters::addFrame(frameTimes[frameIndex]);
+
+    if (Arguments::maxFps <= 0) {
+        return;
+    }
+    Nanos period = 1'000'000'000 / Arguments::maxFps;
+    nextFrame += period;
+    // do not try to catch up after a slow frame
+    if (nextFrame < now) {
+        nextFrame = now;
+    }
+    waitUntil(nextFrame);
+}
+
+void FramePacer::wait(Nanos duration) {
+    waitUntil(getNanos() + duration);
+}
+
+float FramePacer::getFrameMillis() {
+    return frameTimes[frameIndex] / 1'000'000.0f;
+}
+
+float FramePacer::getAverageFrameMillis() {
+    return frameTimeSum / (FRAME_SAMPLES * 1'000'000.0f);
+}
+
+float FramePacer::getMaxFrameMillis() {
+    return *std::max_element(frameTimes.begin(), frameTimes.end()) / 1'000'000.0f;
+}
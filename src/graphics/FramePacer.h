@@ -0,0 +1,18 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <cstdint>
+
+namespace FramePacer {
+    typedef int64_t Nanos;
+
+    void startFrame();
+    void endFrame();
+    void wait(Nanos duration);
+
+    float getFrameMillis();
+    float getAverageFrameMillis();
+    float getMaxFrameMillis();
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "GpuTimer.h"
+
+#include "graphics/gl/Commands.h"
+#include "graphics/gl/Glew.h"
+
+#ifdef PROFILER
+// results are read this many frames later so that reading never stalls
+static constexpr int FRAMES = 4;
+static constexpr int MAX_PASSES = 16;
+
+struct Frame final {
+    GLuint queries[MAX_PASSES];
+    const char* names[MAX_PASSES];
+    int passes;
+};
+
+struct Result final {
+    const char* name;
+    float millis;
+};
+
+static Frame frames[FRAMES];
+static int frameIndex = 0;
+static bool initialized = false;
+static int depth = 0;
+
+static Result results[MAX_PASSES];
+static int resultCount = 0;
+
+static void init() {
+    for (Frame& frame : frames) {
+        glGenQueries(MAX_PASSES, frame.queries);
+        frame.passes = 0;
+    }
+    initialized = true;
+}
+
+static void readResults(Frame& frame) {
+    if (frame.passes == 0) {
+        return;
+    }
+    GLint available = 0;
+    glGetQueryObjectiv(frame.queries[frame.passes - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return;
+    }
+    for (int i = 0; i < frame.passes; i++) {
+        GLuint64 nanos = 0;
+        glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &nanos);
+        results[i] = {frame.names[i], nanos / 1'000'000.0f};
+    }
+    resultCount = frame.passes;
+}
+
+void GpuTimer::begin(const char* name) {
+    if (!initialized) {
+        init();
+    }
+    depth++;
+    Frame& frame = frames[frameIndex];
+    if (depth > 1 || frame.passes >= MAX_PASSES) {
+        return;
+    }
+    frame.names[frame.passes] = name;
+    GL::Commands::add(
+        [query = frame.queries[frame.passes]] { glBeginQuery(GL_TIME_ELAPSED, query); });
+}
+
+void GpuTimer::end() {
+    depth--;
+    Frame& frame = frames[frameIndex];
+    if (depth > 0 || frame.passes >= MAX_PASSES) {
+        return;
+    }
+    GL::Commands::add([] { glEndQuery(GL_TIME_ELAPSED); });
+    frame.passes++;
+}
+
+void GpuTimer::endFrame() {
+    if (!initialized) {
+        return;
+    }
+    frameIndex = (frameIndex + 1) % FRAMES;
+    Frame& oldest = frames[frameIndex];
+    readResults(oldest);
+    oldest.passes = 0;
+}
+
+int GpuTimer::getPassCount() {
+    return resultCount;
+}
+
+const char* GpuTimer::getPassName(int index) {
+    return results[index].name;
+}
+
+float GpuTimer::getPassMillis(int index) {
+    return results[index].millis;
+}
+
+GpuTimer::Pass::Pass(const char* name) {
+    begin(name);
+}
+
+GpuTimer::Pass::~Pass() {
+    end();
+}
+
+#endif
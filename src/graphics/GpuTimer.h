@@ -0,0 +1,30 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include "Profiler.h"
+
+#ifdef PROFILER
+#define PROFILE_GPU_PASS(name) GpuTimer::Pass PROFILE_CONCAT(gpuPass, __LINE__)(name)
+#else
+#define PROFILE_GPU_PASS(name)
+#endif
+
+#ifdef PROFILER
+// GL_TIME_ELAPSED queries cannot overlap, passes inside of another pass are not measured
+namespace GpuTimer {
+    void begin(const char* name);
+    void end();
+    void endFrame();
+
+    int getPassCount();
+    const char* getPassName(int index);
+    float getPassMillis(int index);
+
+    struct Pass final {
+        Pass(const char* name);
+        ~Pass();
+    };
+}
+#endif
+
+#endif
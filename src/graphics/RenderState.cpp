@@ -4,6 +4,7 @@
 #include "Game.h"
 #include "Utils.h"
 #include "graphics/Window.h"
+#include "graphics/gl/Commands.h"
 #include "graphics/gl/Shader.h"
 #include "graphics/gl/VertexBuffer.h"
 #include "math/Matrix.h"
@@ -245,27 +246,31 @@ void RenderState::resize(int width, int height) {
 }
 
 static void clear() {
-    if (!Player::invertColors()) {
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    } else {
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-    }
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    GL::Commands::add([invert = Player::invertColors()] {
+        if (!invert) {
+            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        } else {
+            glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+        }
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    });
 }
 
 void RenderState::prepareEffectFramebuffer() {
-    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.id);
+    GL::Commands::add([] { glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.id); });
     clear();
 }
 
 void RenderState::bindAndClearDefaultFramebuffer() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GL::Commands::add([] { glBindFramebuffer(GL_FRAMEBUFFER, 0); });
     clear();
 }
 
 static void bindTextureTo(int textureUnit) {
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(textureTarget, texture);
+    GL::Commands::add([textureUnit] {
+        glActiveTexture(GL_TEXTURE0 + textureUnit);
+        glBindTexture(textureTarget, texture);
+    });
 }
 
 void RenderState::startMixing() {
@@ -332,13 +337,15 @@ void RenderState::renderTitleScreenEffects(float lag) {
 }
 
 void RenderState::enableBlending() {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glBlendEquation(GL_FUNC_ADD);
+    GL::Commands::add([] {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glBlendEquation(GL_FUNC_ADD);
+    });
 }
 
 void RenderState::disableBlending() {
-    glDisable(GL_BLEND);
+    GL::Commands::add([] { glDisable(GL_BLEND); });
 }
 
 void RenderState::setZoom(float z, Vector offset) {
@@ -17,6 +17,16 @@
 static GL::Shader shader;
 static GL::VertexBuffer buffer;
 static GL::Texture abilities;
+static SDL_Surface* abilitiesSurface = nullptr;
+
+bool TextureRenderer::load() {
+    abilitiesSurface = IMG_Load("assets/abilities.png");
+    if (abilitiesSurface == nullptr) {
+        Utils::print("cannot load abilities: %s\n", IMG_GetError());
+        return true;
+    }
+    return false;
+}
 
 bool TextureRenderer::init() {
     if (shader.compile({"assets/shaders/texture.vs", "assets/shaders/texture.fs"})) {
@@ -25,13 +35,9 @@ bool TextureRenderer::init() {
     buffer.init(GL::VertexBuffer::Attributes().addVector2().addVector2().addRGBA());
 
     abilities.init();
-    SDL_Surface* data = IMG_Load("assets/abilities.png");
-    if (data == nullptr) {
-        Utils::print("cannot load abilities: %s\n", IMG_GetError());
-        return true;
-    }
-    abilities.setData(data->w, data->h, data->pixels);
-    SDL_FreeSurface(data);
+    abilities.setData(abilitiesSurface->w, abilitiesSurface->h, abilitiesSurface->pixels);
+    SDL_FreeSurface(abilitiesSurface);
+    abilitiesSurface = nullptr;
     return false;
 }
 
@@ -48,10 +54,8 @@ static void renderBox(const Vector& min, const Vector& max, const Vector& tMin,
     data.add(max.x).add(min.y).add(tMax.x).add(tMin.y).add(c);
     data.add(min.x).add(max.y).add(tMin.x).add(tMax.y).add(c);
     data.add(max.x).add(max.y).add(tMax.x).add(tMax.y).add(c);
-    data.add(max.x).add(min.y).add(tMax.x).add(tMin.y).add(c);
-    data.add(min.x).add(max.y).add(tMin.x).add(tMax.y).add(c);
     buffer.setStreamData(data.getData(), data.getSize());
-    buffer.drawTriangles(6);
+    buffer.drawQuads(1);
 }
 
 void TextureRenderer::renderIcon(const Vector& min, const Vector& max, Ability a, int alpha,
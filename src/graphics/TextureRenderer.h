@@ -6,6 +6,7 @@
 #include "player/Ability.h"
 
 namespace TextureRenderer {
+    bool load();
     bool init();
     void render(float lag);
     void renderIcon(const Vector& min, const Vector& max, Ability a, int alpha, float smooth);
@@ -1,7 +1,10 @@
 #include "Window.h"
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 #include <SDL.h>
 #include <algorithm>
@@ -12,8 +15,12 @@
 #include "Arguments.h"
 #include "Game.h"
 #include "Input.h"
+#include "PerfCounters.h"
 #include "Profiler.h"
 #include "Utils.h"
+#include "graphics/FramePacer.h"
+#include "graphics/GpuTimer.h"
+#include "graphics/gl/Commands.h"
 #include "graphics/gl/Glew.h"
 #include "objects/Objects.h"
 #include "sound/SoundManager.h"
@@ -22,7 +29,10 @@ typedef int64_t Nanos;
 static constexpr Nanos NANOS_PER_TICK = 1'000'000'000L * Window::SECONDS_PER_TICK;
 
 static SDL_Window* window = nullptr;
-static bool running = false;
+static std::atomic<bool> running = false;
+// guards the game state while the simulation runs on its own thread
+static std::mutex stateMutex;
+static std::atomic<Nanos> lastTickTime = 0;
 static int width = 850;
 static int height = 480;
 static int drawableWidth = 850;
@@ -64,10 +74,6 @@ bool Window::init() {
         Utils::printError("Disabled audio due to sound manager init failure\n");
     }
 
-    if (SoundManager::loadSounds()) {
-        return true;
-    }
-
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
@@ -175,11 +181,20 @@ bool Window::isFullscreen() {
     return SDL_GetWindowFlags(window) & SDL_WINDOW_FULLSCREEN_DESKTOP;
 }
 
+static Nanos getNanos() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch()).count();
+}
+
 static void pollEvents() {
     SDL_Event e;
+    // SDL timestamps are milliseconds since SDL_Init
+    Nanos sdlStart = getNanos() - static_cast<Nanos>(SDL_GetTicks()) * 1'000'000;
 
     while (SDL_PollEvent(&e)) {
         ImGui_ImplSDL2_ProcessEvent(&e);
+        Nanos eventTime = sdlStart + static_cast<Nanos>(e.common.timestamp) * 1'000'000;
+        Input::Internal::setEventTime(eventTime);
 
         switch (e.type) {
             case SDL_QUIT: {
@@ -252,6 +267,7 @@ static void pollEvents() {
                     case SDLK_s: Input::Internal::setButtonReleased(ButtonType::DOWN); break;
                     case SDLK_p: Input::Internal::setButtonReleased(ButtonType::PAUSE); break;
                     case SDLK_F11: Window::toggleFullscreen(); break;
+                    case SDLK_F12: PerfCounters::write(Arguments::perfLog); break;
                     case SDLK_ESCAPE: Input::Internal::setButtonReleased(ButtonType::PAUSE); break;
                 }
                 break;
@@ -419,29 +435,101 @@ static void pollEvents() {
     }
 }
 
-static Nanos getNanos() {
-    using namespace std::chrono;
-    return duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch()).count();
+static void renderFrame(float lag) {
+    Game::render(lag);
+    {
+#ifdef PROFILER
+        PROFILE_SCOPE("Post Game Render");
+        // Start the Dear ImGui frame
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplSDL2_NewFrame(window);
+        ImGui::NewFrame();
+#ifndef NDEBUG
+        Game::renderImGui();
+#endif
+        Profiler::renderImGui();
+        ImGui::Render();
+        // the draw data stays valid until the next ImGui frame
+        GL::Commands::add([drawData = ImGui::GetDrawData()] {
+            ImGui_ImplOpenGL3_RenderDrawData(drawData);
+        });
+        GpuTimer::endFrame();
+#endif
+    }
 }
 
-void Window::run() {
-    if (Game::init()) {
-        return;
+static void swapWindow() {
+    PROFILE_SCOPE("Buffer Swap");
+    SDL_GL_SwapWindow(window);
+    static bool firstFrame = true;
+    if (firstFrame) {
+        // SDL counts from SDL_Init in Window::init
+        Utils::print("first frame after %ums\n", SDL_GetTicks());
+        firstFrame = false;
     }
-    if (Arguments::muted) {
-        SoundManager::mute();
+}
+
+static void simulate() {
+    Nanos nextTick = getNanos();
+    while (running) {
+        nextTick += NANOS_PER_TICK;
+        FramePacer::wait(nextTick - getNanos());
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            Input::Internal::update(nextTick);
+            Game::tick();
+            PerfCounters::addTick();
+            lastTickTime = getNanos();
+        }
+        Nanos behind = getNanos() - nextTick;
+        if (behind > 5 * NANOS_PER_TICK) {
+            int skip = behind / NANOS_PER_TICK;
+            nextTick += skip * NANOS_PER_TICK;
+            PerfCounters::addSkippedTicks(skip);
+            fprintf(stderr, "Lagging, skipped %d ticks\n", skip);
+        }
     }
+}
 
-    running = true;
+static void runThreaded() {
+    lastTickTime = getNanos();
+    std::thread simulation(simulate);
+    while (running) {
+        FramePacer::startFrame();
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            {
+                PROFILE_SCOPE("Event Poll");
+                pollEvents();
+            }
+            SoundManager::update();
+            // the recorded commands with their copied data are the snapshot of the frame, the
+            // driver work and a blocking swap do not hold back the simulation
+            GL::Commands::beginRecording();
+            float lag = static_cast<float>(getNanos() - lastTickTime) / NANOS_PER_TICK;
+            renderFrame(std::clamp(lag, 0.0f, 1.0f));
+            GL::Commands::endRecording();
+        }
+        {
+            PROFILE_SCOPE("GL Submit");
+            GL::Commands::submit();
+        }
+        swapWindow();
+        FramePacer::endFrame();
+    }
+    simulation.join();
+}
+
+static void runSingleThreaded() {
     Nanos lag = 0;
     Nanos lastTime = getNanos();
     while (running) {
+        FramePacer::startFrame();
         {
-#ifndef NDEBUG
-            Profiler::Timer timer(Profiler::eventPollNanos);
-#endif
+            PROFILE_SCOPE("Event Poll");
             pollEvents();
         }
+        SoundManager::update();
 
         Nanos time = getNanos();
         lag += time - lastTime;
@@ -449,37 +537,54 @@ void Window::run() {
         int i = 0;
         while (lag >= NANOS_PER_TICK) {
             lag -= NANOS_PER_TICK;
-            Input::Internal::update();
+            if (i > 0) {
+                pollEvents();
+            }
+            // only events until the end of the simulated tick are visible to it
+            Input::Internal::update(time - lag);
             Game::tick();
+            PerfCounters::addTick();
             i++;
             if (i > 5) {
                 int skip = lag / NANOS_PER_TICK;
                 lag -= skip * NANOS_PER_TICK;
+                PerfCounters::addSkippedTicks(skip);
                 fprintf(stderr, "Lagging, skipped %d ticks\n", skip);
             }
         }
-
-        Game::render(static_cast<float>(lag) / NANOS_PER_TICK);
-        {
-#ifndef NDEBUG
-            Profiler::Timer timer(Profiler::postGameRenderNanos);
-            // Start the Dear ImGui frame
-            ImGui_ImplOpenGL3_NewFrame();
-            ImGui_ImplSDL2_NewFrame(window);
-            ImGui::NewFrame();
-            Game::renderImGui();
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-#endif
-        }
-        {
-#ifndef NDEBUG
-            Profiler::Timer timer(Profiler::bufferSwapNanos);
-#endif
-            SDL_GL_SwapWindow(window);
+        if (Arguments::renderOnTick && i == 0) {
+            // nothing changed since the last frame, wait for the next tick instead
+            FramePacer::wait(NANOS_PER_TICK - lag);
+            continue;
         }
+
+        renderFrame(static_cast<float>(lag) / NANOS_PER_TICK);
+        swapWindow();
+        FramePacer::endFrame();
+    }
+}
+
+void Window::run() {
+    if (Game::init()) {
+        return;
+    }
+    if (Arguments::muted) {
+        SoundManager::mute();
+    }
+
+    running = true;
+    if (Arguments::threaded) {
+        runThreaded();
+    } else {
+        runSingleThreaded();
     }
 
+    PerfCounters::write(Arguments::perfLog);
+#ifdef PROFILER
+    if (Arguments::traceFile != nullptr) {
+        Profiler::writeTrace(Arguments::traceFile);
+    }
+#endif
     Input::closeController();
     Objects::clear();
     Objects::clearPrototypes();
@@ -0,0 +1,46 @@
+#include "Commands.h"
+
+#include <vector>
+
+static bool recording = false;
+static std::vector<std::function<void()>> commands;
+// the copies keep their capacity over frames
+static std::vector<std::vector<char>> copies;
+static size_t usedCopies = 0;
+
+void GL::Commands::beginRecording() {
+    recording = true;
+}
+
+void GL::Commands::endRecording() {
+    recording = false;
+}
+
+bool GL::Commands::isRecording() {
+    return recording;
+}
+
+void GL::Commands::record(std::function<void()> command) {
+    commands.push_back(std::move(command));
+}
+
+const void* GL::Commands::keep(const void* data, size_t length) {
+    if (!recording || data == nullptr) {
+        return data;
+    }
+    if (usedCopies == copies.size()) {
+        copies.emplace_back();
+    }
+    std::vector<char>& copy = copies[usedCopies++];
+    const char* bytes = static_cast<const char*>(data);
+    copy.assign(bytes, bytes + length);
+    return copy.data();
+}
+
+void GL::Commands::submit() {
+    for (auto& command : commands) {
+        command();
+    }
+    commands.clear();
+    usedCopies = 0;
+}
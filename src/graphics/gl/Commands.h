@@ -0,0 +1,32 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+// GL calls made while recording are stored and run by submit, so that a frame can be built
+// while the game state is locked and sent to the driver after the lock is released
+namespace GL {
+    namespace Commands {
+        void beginRecording();
+        void endRecording();
+        bool isRecording();
+        // everything a recorded command references must live until submit
+        void record(std::function<void()> command);
+        // returns a copy which lives until submit while recording and the data itself otherwise
+        const void* keep(const void* data, size_t length);
+        void submit();
+
+        template <typename F>
+        void add(F&& command) {
+            if (isRecording()) {
+                record(std::forward<F>(command));
+            } else {
+                command();
+            }
+        }
+    }
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "Shader.h"
+#include "Commands.h"
 #include "Utils.h"
 #include <fstream>
 
@@ -89,7 +90,7 @@ void GL::Shader::use() {
 #ifndef NDEBUG
     boundProgram = program;
 #endif
-    glUseProgram(program);
+    GL::Commands::add([this] { glUseProgram(program); });
 }
 
 void GL::Shader::setFloat(const char* name, float f) {
@@ -98,7 +99,7 @@ void GL::Shader::setFloat(const char* name, float f) {
         fprintf(stderr, "setFloat on invalid shader: %d instead of %d\n", boundProgram, program);
     }
 #endif
-    glUniform1f(glGetUniformLocation(program, name), f);
+    GL::Commands::add([this, name, f] { glUniform1f(glGetUniformLocation(program, name), f); });
 }
 
 void GL::Shader::setInt(const char* name, int i) {
@@ -107,7 +108,7 @@ void GL::Shader::setInt(const char* name, int i) {
         fprintf(stderr, "setInt on invalid shader: %d instead of %d\n", boundProgram, program);
     }
 #endif
-    glUniform1i(glGetUniformLocation(program, name), i);
+    GL::Commands::add([this, name, i] { glUniform1i(glGetUniformLocation(program, name), i); });
 }
 
 void GL::Shader::setVector(const char* name, Vector vec) {
@@ -116,7 +117,20 @@ void GL::Shader::setVector(const char* name, Vector vec) {
         fprintf(stderr, "setVector on invalid shader: %d instead of %d\n", boundProgram, program);
     }
 #endif
-    glUniform2f(glGetUniformLocation(program, name), vec.x, vec.y);
+    GL::Commands::add(
+        [this, name, vec] { glUniform2f(glGetUniformLocation(program, name), vec.x, vec.y); });
+}
+
+void GL::Shader::setColor(const char* name, Color c) {
+#ifndef NDEBUG
+    if (program != boundProgram) {
+        fprintf(stderr, "setColor on invalid shader: %d instead of %d\n", boundProgram, program);
+    }
+#endif
+    auto [r, g, b, a] = ColorUtils::unpackFloat(c);
+    GL::Commands::add([this, name, r = r, g = g, b = b, a = a] {
+        glUniform4f(glGetUniformLocation(program, name), r, g, b, a);
+    });
 }
 
 void GL::Shader::setMatrix(const char* name, const Matrix& matrix) {
@@ -125,7 +139,9 @@ void GL::Shader::setMatrix(const char* name, const Matrix& matrix) {
         fprintf(stderr, "setMatrix on invalid shader: %d instead of %d\n", boundProgram, program);
     }
 #endif
-    glUniformMatrix4fv(glGetUniformLocation(program, name), 1, false, matrix.getData());
+    GL::Commands::add([this, name, matrix] {
+        glUniformMatrix4fv(glGetUniformLocation(program, name), 1, false, matrix.getData());
+    });
 }
 
 #ifndef NDEBUG
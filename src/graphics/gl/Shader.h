@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "NonCopyable.h"
+#include "graphics/Color.h"
 #include "graphics/gl/Glew.h"
 #include "math/Matrix.h"
 #include "math/Vector.h"
@@ -24,6 +25,7 @@ namespace GL {
         void setFloat(const char* name, float f);
         void setInt(const char* name, int i);
         void setVector(const char* name, Vector v);
+        void setColor(const char* name, Color c);
         void setMatrix(const char* name, const Matrix& matrix);
 #ifndef NDEBUG
         bool isBound() const;
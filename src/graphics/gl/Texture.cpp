@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "Commands.h"
 #include <iostream>
 GL::Texture::Texture() : texture(0) {
 }
@@ -9,18 +10,44 @@ GL::Texture::~Texture() {
     }
 }
 
-void GL::Texture::init() {
+void GL::Texture::init(bool linear) {
     glGenTextures(1, &texture);
     bind();
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GLint filter = linear ? GL_LINEAR : GL_NEAREST;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 }
 
 void GL::Texture::setData(int width, int height, const void* data) {
-    bind();
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    data = GL::Commands::keep(data, width * height * 4);
+    GL::Commands::add([this, width, height, data] {
+        bind();
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     data);
+    });
+}
+
+void GL::Texture::setByteData(int width, int height, const void* data) {
+    data = GL::Commands::keep(data, width * height);
+    GL::Commands::add([this, width, height, data] {
+        bind();
+        // rows of single byte texels are not 4 byte aligned for arbitrary widths
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, width, height, 0, GL_RED_INTEGER,
+                     GL_UNSIGNED_BYTE, data);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    });
+}
+
+void GL::Texture::setByte(int x, int y, unsigned char value) {
+    GL::Commands::add([this, x, y, value] {
+        bind();
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_BYTE, &value);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    });
 }
 
 void GL::Texture::bind() const {
@@ -28,6 +55,8 @@ void GL::Texture::bind() const {
 }
 
 void GL::Texture::bindTo(int index) const {
-    glActiveTexture(GL_TEXTURE0 + index);
-    bind();
+    GL::Commands::add([this, index] {
+        glActiveTexture(GL_TEXTURE0 + index);
+        bind();
+    });
 }
\ No newline at end of file
@@ -10,8 +10,10 @@ namespace GL {
         Texture();
         ~Texture();
 
-        void init();
+        void init(bool linear = true);
         void setData(int width, int height, const void* data = nullptr);
+        void setByteData(int width, int height, const void* data);
+        void setByte(int x, int y, unsigned char value);
         void bindTo(int index = 0) const;
 
       private:
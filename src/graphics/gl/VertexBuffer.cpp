@@ -1,6 +1,13 @@
 #include "VertexBuffer.h"
+#include <algorithm>
 #include <iostream>
 
+#include "Commands.h"
+#include "PerfCounters.h"
+
+static GLuint quadIndexBuffer = 0;
+static int quadIndexCapacity = 0;
+
 GL::VertexBuffer::Attributes& GL::VertexBuffer::Attributes::addFloat(int count) {
     data.push_back({GL_FLOAT, false, count, static_cast<int>(sizeof(float) * count)});
     return *this;
@@ -28,10 +35,10 @@ GL::VertexBuffer::Attributes& GL::VertexBuffer::Attributes::addRGBA() {
 }
 
 GL::VertexBuffer::VertexBuffer()
-    : vertexArray(0), vertexBuffer(0)
+    : vertexArray(0), vertexBuffer(0), vertexSize(0)
 #ifndef NDEBUG
       ,
-      vertexSize(0), dataSize(0)
+      dataSize(0)
 #endif
 {
 }
@@ -64,9 +71,7 @@ void GL::VertexBuffer::init(const Attributes& a) {
         glEnableVertexAttribArray(i);
         offset += d.size;
     }
-#ifndef NDEBUG
     vertexSize = offset;
-#endif
 }
 
 void GL::VertexBuffer::bindBuffer() const {
@@ -78,8 +83,14 @@ void GL::VertexBuffer::bindArray() const {
 }
 
 void GL::VertexBuffer::setData(const void* data, int length, int dataType) {
-    bindBuffer();
-    glBufferData(GL_ARRAY_BUFFER, length, data, dataType);
+    data = GL::Commands::keep(data, length);
+    GL::Commands::add([this, data, length, dataType] {
+        bindBuffer();
+        glBufferData(GL_ARRAY_BUFFER, length, data, dataType);
+    });
+    if (data != nullptr && vertexSize > 0) {
+        PerfCounters::addUploadedVertices(length / vertexSize);
+    }
 #ifndef NDEBUG
     if (vertexSize == 0) {
         fprintf(stderr, "GL::VertexBuffer::setData before GL::VertexBuffer::init\n");
@@ -101,11 +112,30 @@ void GL::VertexBuffer::setStreamData(const void* data, int length) {
     setData(data, length, GL_STREAM_DRAW);
 }
 
+void GL::VertexBuffer::updateData(const void* data, int length, int offset) {
+    data = GL::Commands::keep(data, length);
+    GL::Commands::add([this, data, length, offset] {
+        bindBuffer();
+        glBufferSubData(GL_ARRAY_BUFFER, offset, length, data);
+    });
+    if (vertexSize > 0) {
+        PerfCounters::addUploadedVertices(length / vertexSize);
+    }
+#ifndef NDEBUG
+    if (offset + length > dataSize) {
+        fprintf(stderr, "invalid range on updateData: %d %d %d\n", offset, length, dataSize);
+    }
+#endif
+}
+
 void setData(const void* data, int length, int dataType);
 
 void GL::VertexBuffer::drawTriangles(int vertices, int offset) const {
-    bindArray();
-    glDrawArrays(GL_TRIANGLES, offset, vertices);
+    GL::Commands::add([this, vertices, offset] {
+        bindArray();
+        glDrawArrays(GL_TRIANGLES, offset, vertices);
+    });
+    PerfCounters::addDrawCall();
 #ifndef NDEBUG
     if (vertexSize * vertices > dataSize) {
         fprintf(stderr, "invalid vertices on drawTriangles: %d %d %d\n", vertexSize, vertices,
@@ -113,3 +143,43 @@ void GL::VertexBuffer::drawTriangles(int vertices, int offset) const {
     }
 #endif
 }
+
+// quads are four vertices drawn as the triangles (0, 1, 2) and (2, 1, 3)
+static void bindQuadIndexBuffer(int quads) {
+    if (quadIndexBuffer == 0) {
+        glGenBuffers(1, &quadIndexBuffer);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndexBuffer);
+    if (quads <= quadIndexCapacity) {
+        return;
+    }
+    quadIndexCapacity = std::max(std::max(quads, quadIndexCapacity * 2), 1024);
+    std::vector<GLuint> indices;
+    indices.reserve(quadIndexCapacity * 6);
+    for (int i = 0; i < quadIndexCapacity; i++) {
+        GLuint base = i * 4;
+        indices.push_back(base);
+        indices.push_back(base + 1);
+        indices.push_back(base + 2);
+        indices.push_back(base + 2);
+        indices.push_back(base + 1);
+        indices.push_back(base + 3);
+    }
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(),
+                 GL_STATIC_DRAW);
+}
+
+void GL::VertexBuffer::drawQuads(int quads, int offset) const {
+    GL::Commands::add([this, quads, offset] {
+        bindArray();
+        bindQuadIndexBuffer(quads);
+        glDrawElementsBaseVertex(GL_TRIANGLES, quads * 6, GL_UNSIGNED_INT, nullptr, offset);
+    });
+    PerfCounters::addDrawCall();
+#ifndef NDEBUG
+    if (vertexSize * (offset + quads * 4) > dataSize) {
+        fprintf(stderr, "invalid quads on drawQuads: %d %d %d %d\n", vertexSize, quads, offset,
+                dataSize);
+    }
+#endif
+}
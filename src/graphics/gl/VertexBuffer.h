@@ -38,7 +38,9 @@ namespace GL {
 
         void setStaticData(const void* data, int length);
         void setStreamData(const void* data, int length);
+        void updateData(const void* data, int length, int offset);
         void drawTriangles(int vertices, int offset = 0) const;
+        void drawQuads(int quads, int offset = 0) const;
 
       private:
         void setData(const void* data, int length, int dataType);
@@ -48,9 +50,9 @@ namespace GL {
 
         GLuint vertexArray;
         GLuint vertexBuffer;
+        int vertexSize;
 
 #ifndef NDEBUG
-        int vertexSize;
         int dataSize;
 #endif
     };
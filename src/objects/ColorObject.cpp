@@ -65,7 +65,7 @@ void ColorObject::render(float lag) {
 }
 
 std::shared_ptr<ObjectBase> ColorObject::clone() {
-    return std::make_shared<ColorObject>(data);
+    return Objects::create<ColorObject>(data);
 }
 
 #ifndef NDEBUG
@@ -94,7 +94,7 @@ void DoorObject::renderEditor(float lag, bool inPalette) {
 }
 
 std::shared_ptr<ObjectBase> DoorObject::clone() {
-    return std::make_shared<DoorObject>(data);
+    return Objects::create<DoorObject>(data);
 }
 
 #ifndef NDEBUG
@@ -115,8 +115,8 @@ Vector DoorObject::getSize() const {
     return data.size;
 }
 
-bool DoorObject::isDoorOfType(int type) const {
-    return data.type == type;
+int DoorObject::getDoorType() const {
+    return data.type;
 }
 
 void DoorObject::addKey() {
@@ -131,3 +131,17 @@ void DoorObject::reset() {
     alpha = START_ALPHA;
     particles->stop();
 }
+
+void DoorObject::saveState(std::vector<char>& state) const {
+    saveStateValue(state, maxKeys);
+    saveStateValue(state, keys);
+    saveStateValue(state, alpha);
+    saveStateValue(state, playedOpenEffect);
+}
+
+void DoorObject::loadState(const char*& state) {
+    loadStateValue(state, maxKeys);
+    loadStateValue(state, keys);
+    loadStateValue(state, alpha);
+    loadStateValue(state, playedOpenEffect);
+}
@@ -25,9 +25,11 @@ class DoorObject : public Object<DoorObjectData> {
     void renderEditor(float lag, bool inPalette) override;
     std::shared_ptr<ObjectBase> clone() override;
     Vector getSize() const override;
-    bool isDoorOfType(int type) const override;
+    int getDoorType() const override;
     void addKey() override;
     void reset() override;
+    void saveState(std::vector<char>& state) const override;
+    void loadState(const char*& state) override;
 
 #ifndef NDEBUG
     void initTileEditorData(std::vector<TileEditorProp>& props) override;
@@ -29,15 +29,20 @@ void KeyObject::postInit() {
     particles->play();
 }
 
-void KeyObject::onCollision() {
+bool KeyObject::isTrigger() const {
+    return true;
+}
+
+void KeyObject::onTriggerEnter() {
     collected = true;
     SoundManager::playSoundEffect(Sound::COLLECT);
 
-    std::shared_ptr<ObjectBase> door = Objects::findDoor(data.type);
-    if (door == nullptr) {
+    door = Objects::findDoor(data.type);
+    ObjectBase* o = door.get();
+    if (o == nullptr) {
         goal = position;
     } else {
-        goal = door->position + door->getSize() * 0.5f - Vector(0.5f, 0.5f);
+        goal = o->position + o->getSize() * 0.5f - Vector(0.5f, 0.5f);
     }
 }
 
@@ -79,9 +84,10 @@ void KeyObject::tick() {
     } else {
         renderPosition = goal;
         added = true;
-        std::shared_ptr<ObjectBase> door = Objects::findDoor(data.type);
-        if (door != nullptr) {
-            door->addKey();
+        // the door may have been destroyed while the key was flying
+        ObjectBase* o = door.get();
+        if (o != nullptr) {
+            o->addKey();
         }
     }
     particles->position = renderPosition + this->getSize() / 2.0f;
@@ -124,7 +130,7 @@ void KeyObject::renderEditor(float lag, bool inPalette) {
 }
 
 std::shared_ptr<ObjectBase> KeyObject::clone() {
-    return std::make_shared<KeyObject>(data);
+    return Objects::create<KeyObject>(data);
 }
 
 #ifndef NDEBUG
@@ -150,9 +156,28 @@ void KeyObject::reset() {
     lastRenderPosition = position;
     renderPosition = position;
     goal = Vector();
+    door = Objects::Handle<ObjectBase>();
     particles->play();
 }
 
-bool KeyObject::isKeyOfType(int type) const {
-    return data.type == type;
+int KeyObject::getKeyType() const {
+    return data.type;
+}
+
+// the render position decides when the key reaches its door
+void KeyObject::saveState(std::vector<char>& state) const {
+    saveStateValue(state, goal);
+    saveStateValue(state, door);
+    saveStateValue(state, renderPosition);
+    saveStateValue(state, collected);
+    saveStateValue(state, added);
+}
+
+void KeyObject::loadState(const char*& state) {
+    loadStateValue(state, goal);
+    loadStateValue(state, door);
+    loadStateValue(state, renderPosition);
+    loadStateValue(state, collected);
+    loadStateValue(state, added);
+    lastRenderPosition = renderPosition;
 }
@@ -2,6 +2,7 @@
 #define KEYOBJECT_H
 
 #include "Object.h"
+#include "Objects.h"
 #include "math/Vector.h"
 #include "particles/ParticleSystem.h"
 #include "player/Ability.h"
@@ -18,14 +19,17 @@ class KeyObject : public Object<KeyObjectData> {
 
     void postInit() override;
     void tick() override;
-    void onCollision() override;
+    bool isTrigger() const override;
+    void onTriggerEnter() override;
     bool collidesWith(const Vector& position, const Vector& size) const override;
     void lateRender(float lag) override;
     void renderEditor(float lag, bool inPalette) override;
     std::shared_ptr<ObjectBase> clone() override;
     Vector getSize() const override;
     void reset() override;
-    bool isKeyOfType(int type) const override;
+    int getKeyType() const override;
+    void saveState(std::vector<char>& state) const override;
+    void loadState(const char*& state) override;
 
   private:
     std::shared_ptr<ParticleSystem> particles;
@@ -38,6 +42,7 @@ class KeyObject : public Object<KeyObjectData> {
     void renderColor(float lag, Color color);
 
     Vector goal;
+    Objects::Handle<ObjectBase> door;
     Vector lastRenderPosition;
     Vector renderPosition;
     int counter;
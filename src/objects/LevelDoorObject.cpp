@@ -1,4 +1,5 @@
 #include "LevelDoorObject.h"
+#include "Objects.h"
 #include <iostream>
 LevelDoorObject::LevelDoorObject() : closed(true) {
 }
@@ -30,5 +31,5 @@ void LevelDoorObject::reset() {
 }
 
 std::shared_ptr<ObjectBase> LevelDoorObject::clone() {
-    return std::make_shared<LevelDoorObject>(data);
+    return Objects::create<LevelDoorObject>(data);
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Savegame.h"
 #include "TextUtils.h"
 #include "graphics/Font.h"
+#include "graphics/gl/Commands.h"
 #include "graphics/gl/Glew.h"
 #include "objects/Objects.h"
 #include "player/Player.h"
@@ -14,24 +15,34 @@
 #include <cmath>
 #include <memory>
 
-LevelTagObject::LevelTagObject(Vector position, Vector size) : bestTimeAlpha(0.f) {
+LevelTagObject::LevelTagObject(Vector position, Vector size)
+    : bestTimeAlpha(0.f), playerInside(false) {
     this->position = position;
     data = {};
     data.size = size;
 }
 
-LevelTagObject::LevelTagObject(LevelTagObjectData data) : bestTimeAlpha(0.f) {
+LevelTagObject::LevelTagObject(LevelTagObjectData data) : bestTimeAlpha(0.f), playerInside(false) {
 }
 
 void LevelTagObject::tick() {
-    bestTimeAlpha += Player::isAllowedToMove() && Player::isColliding(*this) ? 10.f : -10.f;
+    bestTimeAlpha += Player::isAllowedToMove() && playerInside ? 10.f : -10.f;
     bestTimeAlpha = std::max(std::min(bestTimeAlpha, 255), 0);
 }
 
-void LevelTagObject::onCollision() {
+bool LevelTagObject::isTrigger() const {
+    return true;
+}
+
+void LevelTagObject::onTriggerEnter() {
+    playerInside = true;
     Game::setNextLevelIndex(data.level);
 }
 
+void LevelTagObject::onTriggerExit() {
+    playerInside = false;
+}
+
 bool LevelTagObject::collidesWith(const Vector& pPosition, const Vector& pSize) const {
     return position[0] < pPosition[0] + pSize[0] && position[0] + data.size[0] > pPosition[0] &&
            position[1] < pPosition[1] + pSize[1] && position[1] + data.size[1] > pPosition[1];
@@ -62,19 +73,19 @@ void LevelTagObject::renderText(float lag) {
         uint32_t completionTime = Savegame::getCompletionTime(data.level);
         if (completionTime > 0) {
             if (bestTimeAlpha < 150) {
-                glDepthMask(false);
+                GL::Commands::add([] { glDepthMask(false); });
                 TextUtils::drawBestTimeObjectSpace(Player::getPosition(), completionTime,
                                                    bestTimeAlpha);
-                glDepthMask(true);
+                GL::Commands::add([] { glDepthMask(true); });
             } else {
                 TextUtils::drawBestTimeObjectSpace(Player::getPosition(), completionTime,
                                                    bestTimeAlpha);
             }
         } else {
             if (Game::levelStartAlpha() < 150) {
-                glDepthMask(false);
+                GL::Commands::add([] { glDepthMask(false); });
                 TextUtils::drawStartHelp(Player::getPosition(), Game::levelStartAlpha());
-                glDepthMask(true);
+                GL::Commands::add([] { glDepthMask(true); });
             } else {
                 TextUtils::drawStartHelp(Player::getPosition(), Game::levelStartAlpha());
             }
@@ -83,7 +94,7 @@ void LevelTagObject::renderText(float lag) {
 }
 
 std::shared_ptr<ObjectBase> LevelTagObject::clone() {
-    return std::make_shared<LevelTagObject>(data);
+    return Objects::create<LevelTagObject>(data);
 }
 
 #ifndef NDEBUG
@@ -18,7 +18,9 @@ class LevelTagObject : public Object<LevelTagObjectData> {
     LevelTagObject(LevelTagObjectData data);
 
     void tick() override;
-    void onCollision() override;
+    bool isTrigger() const override;
+    void onTriggerEnter() override;
+    void onTriggerExit() override;
     bool collidesWith(const Vector& position, const Vector& size) const override;
     Vector getSize() const override;
     std::shared_ptr<ObjectBase> clone() override;
@@ -31,6 +33,7 @@ class LevelTagObject : public Object<LevelTagObjectData> {
     void applyTileEditorData(float* props) override;
 #endif
     int bestTimeAlpha;
+    bool playerInside;
 };
 
 #endif
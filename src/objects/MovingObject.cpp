@@ -128,7 +128,7 @@ void MovingObject::renderEditor(float lag, bool inPalette) {
 }
 
 std::shared_ptr<ObjectBase> MovingObject::clone() {
-    return std::make_shared<MovingObject>(data);
+    return Objects::create<MovingObject>(data);
 }
 
 #ifndef NDEBUG
@@ -166,3 +166,17 @@ bool MovingObject::hasMoved() const {
     Vector diff = lastPosition - position;
     return diff.x != 0 || diff.y != 0;
 }
+
+void MovingObject::saveState(std::vector<char>& state) const {
+    saveStateValue(state, position);
+    saveStateValue(state, lastPosition);
+    saveStateValue(state, velocity);
+    saveStateValue(state, movingBack);
+}
+
+void MovingObject::loadState(const char*& state) {
+    loadStateValue(state, position);
+    loadStateValue(state, lastPosition);
+    loadStateValue(state, velocity);
+    loadStateValue(state, movingBack);
+}
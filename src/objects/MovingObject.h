@@ -34,6 +34,8 @@ class MovingObject : public Object<MovingObjectData> {
     Vector getSize() const override;
     bool isSpiky(Face f) const;
     bool hasMoved() const override;
+    void saveState(std::vector<char>& state) const override;
+    void loadState(const char*& state) override;
 
 #ifndef NDEBUG
     void initTileEditorData(std::vector<TileEditorProp>& props) override;
@@ -89,7 +89,7 @@ void MovingSwitchObject::renderEditor(float lag, bool inPalette) {
 }
 
 std::shared_ptr<ObjectBase> MovingSwitchObject::clone() {
-    return std::make_shared<MovingSwitchObject>(data.size, data.goal, data.speed, seen);
+    return Objects::create<MovingSwitchObject>(data.size, data.goal, data.speed, seen);
 }
 
 void MovingSwitchObject::read(std::ifstream& in) {
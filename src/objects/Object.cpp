@@ -1,10 +1,12 @@
 #include "Object.h"
 
 #include "imgui/ImGuiUtils.h"
+#include "objects/Objects.h"
 #include <imgui.h>
 
 ObjectBase::ObjectBase()
-    : hasWall(true), isStatic(true), shouldDestroy(false), destroyOnLevelLoad(true) {
+    : hasWall(true), isStatic(true), staticRange(-1), shouldDestroy(false),
+      destroyOnLevelLoad(true), sleeping(false) {
 }
 
 void ObjectBase::postInit() {
@@ -14,7 +16,17 @@ void ObjectBase::onFaceCollision(Face playerFace) {
     (void)playerFace;
 }
 
-void ObjectBase::onCollision() {
+bool ObjectBase::isTrigger() const {
+    return false;
+}
+
+void ObjectBase::onTriggerEnter() {
+}
+
+void ObjectBase::onTriggerStay() {
+}
+
+void ObjectBase::onTriggerExit() {
 }
 
 bool ObjectBase::isSolid() const {
@@ -107,6 +119,7 @@ void ObjectBase::renderImGui() {
 
 void ObjectBase::destroy() {
     shouldDestroy = true;
+    Objects::markDestroyPending();
 }
 
 Vector ObjectBase::getSize() const {
@@ -127,14 +140,12 @@ bool ObjectBase::allowSaving() const {
     return true;
 }
 
-bool ObjectBase::isKeyOfType(int type) const {
-    (void)type;
-    return false;
+int ObjectBase::getKeyType() const {
+    return -1;
 }
 
-bool ObjectBase::isDoorOfType(int type) const {
-    (void)type;
-    return false;
+int ObjectBase::getDoorType() const {
+    return -1;
 }
 
 void ObjectBase::addKey() {
@@ -142,4 +153,28 @@ void ObjectBase::addKey() {
 
 bool ObjectBase::hasMoved() const {
     return true;
+}
+
+void ObjectBase::saveState(std::vector<char>&) const {
+}
+
+void ObjectBase::loadState(const char*&) {
+}
+
+void ObjectBase::sleep() {
+    if (!sleeping) {
+        sleeping = true;
+        Objects::markActiveDirty();
+    }
+}
+
+void ObjectBase::wake() {
+    if (sleeping) {
+        sleeping = false;
+        Objects::markActiveDirty();
+    }
+}
+
+bool ObjectBase::isSleeping() const {
+    return sleeping;
 }
\ No newline at end of file
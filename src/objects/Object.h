@@ -2,6 +2,7 @@
 #define OBJECT_H
 
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <memory>
@@ -10,6 +11,16 @@
 #include "TileEditorProp.h"
 #include "player/Face.h"
 
+// index into the object slots of Objects, generation 0 is never valid
+struct ObjectHandle final {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool operator==(const ObjectHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+};
+
 class ObjectBase {
   public:
     ObjectBase();
@@ -17,7 +28,11 @@ class ObjectBase {
 
     virtual void postInit();
     virtual void onFaceCollision(Face playerFace);
-    virtual void onCollision();
+    // trigger callbacks are only called for objects which return true in isTrigger
+    virtual bool isTrigger() const;
+    virtual void onTriggerEnter();
+    virtual void onTriggerStay();
+    virtual void onTriggerExit();
     virtual bool isSolid() const;
     virtual bool isSolidInAnyWorld() const;
     virtual bool collidesWith(const Vector& position, const Vector& size) const;
@@ -36,10 +51,19 @@ class ObjectBase {
                                     const Vector& velocity);
     virtual void reset();
     virtual bool allowSaving() const;
-    virtual bool isKeyOfType(int type) const;
-    virtual bool isDoorOfType(int type) const;
+    // -1 if the object is no key or door
+    virtual int getKeyType() const;
+    virtual int getDoorType() const;
     virtual void addKey();
     virtual bool hasMoved() const;
+    // state which affects the gameplay, restored by searches which rewind the simulation
+    virtual void saveState(std::vector<char>& state) const;
+    virtual void loadState(const char*& state);
+
+    // sleeping objects are neither ticked nor rendered until something wakes them up
+    void sleep();
+    void wake();
+    bool isSleeping() const;
 
 #ifndef NDEBUG
     virtual const char* getTypeName();
@@ -62,12 +86,31 @@ class ObjectBase {
 
     bool hasWall;
     int prototypeId = -1;
+    // index of the pool in Objects which drives this object, -1 for virtual calls
+    int poolId = -1;
+    ObjectHandle handle;
     Vector position;
     bool isStatic;
+    int staticRange;
     bool shouldDestroy;
     bool destroyOnLevelLoad;
+
+  private:
+    bool sleeping;
 };
 
+template <typename T>
+void saveStateValue(std::vector<char>& state, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    state.insert(state.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+void loadStateValue(const char*& state, T& value) {
+    memcpy(&value, state, sizeof(T));
+    state += sizeof(T);
+}
+
 template <typename T>
 class Object : public ObjectBase {
   public:
@@ -1,18 +1,35 @@
 #include "ObjectRenderer.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include "graphics/Buffer.h"
 #include "graphics/RenderState.h"
 #include "graphics/gl/Shader.h"
 #include "graphics/gl/VertexBuffer.h"
+#include "player/Player.h"
 #include "tilemap/tiles/SpikeTile.h"
 
 static GL::Shader shader;
 static GL::VertexBuffer buffer;
-static GL::VertexBuffer staticBuffer;
-static Buffer data[2];
+static GL::VertexBuffer staticBuffer[2];
+// dynamic data followed by the static data of the light and the dark world
+static Buffer data[3];
 static int dataIndex = 0;
-static int staticVertices = 0;
 static bool dirty = true;
+
+static constexpr int VERTEX_SIZE = sizeof(float) * 3 + 4;
+
+struct StaticRange final {
+    int offset[2];
+    int length[2];
+};
+static std::vector<StaticRange> staticRanges;
+static std::vector<int> removedRanges;
+static int staticRangeStart[2] = {0, 0};
+static int staticCapacity[2] = {0, 0};
+static int staticUploaded[2] = {0, 0};
 static float zLayer = -0.4f;
 static Vector scale{1.0f, 1.0f};
 
@@ -21,7 +38,8 @@ bool ObjectRenderer::init() {
         return true;
     }
     buffer.init(GL::VertexBuffer::Attributes().addVector3().addRGBA());
-    staticBuffer.init(GL::VertexBuffer::Attributes().addVector3().addRGBA());
+    staticBuffer[0].init(GL::VertexBuffer::Attributes().addVector3().addRGBA());
+    staticBuffer[1].init(GL::VertexBuffer::Attributes().addVector3().addRGBA());
     return false;
 }
 
@@ -29,7 +47,7 @@ void ObjectRenderer::render() {
     shader.use();
     RenderState::setViewMatrix(shader);
     buffer.setStreamData(data[0].getData(), data[0].getSize());
-    buffer.drawTriangles(data[0].getSize() / (sizeof(float) * 3 + 4));
+    buffer.drawQuads(data[0].getSize() / (VERTEX_SIZE * 4));
     data[0].clear();
 }
 
@@ -37,11 +55,15 @@ void ObjectRenderer::render(const Matrix& view) {
     shader.use();
     shader.setMatrix("view", view);
     buffer.setStreamData(data[0].getData(), data[0].getSize());
-    buffer.drawTriangles(data[0].getSize() / (sizeof(float) * 3 + 4));
+    buffer.drawQuads(data[0].getSize() / (VERTEX_SIZE * 4));
     data[0].clear();
 }
 
 void ObjectRenderer::clearStaticBuffer() {
+    data[1].clear();
+    data[2].clear();
+    staticRanges.clear();
+    removedRanges.clear();
     dirty = true;
 }
 
@@ -49,16 +71,74 @@ bool ObjectRenderer::dirtyStaticBuffer() {
     return dirty;
 }
 
+static void uploadStaticRanges(int world) {
+    const Buffer& staticData = data[1 + world];
+    GL::VertexBuffer& buffer = staticBuffer[world];
+    int size = staticData.getSize();
+    const char* bytes = static_cast<const char*>(staticData.getData());
+    if (dirty || size > staticCapacity[world]) {
+        // leave room for objects which are added later
+        staticCapacity[world] = std::max(size * 2, VERTEX_SIZE * 1024);
+        buffer.setStaticData(nullptr, staticCapacity[world]);
+        buffer.updateData(bytes, size, 0);
+        staticUploaded[world] = size;
+        return;
+    }
+    if (size > staticUploaded[world]) {
+        buffer.updateData(bytes + staticUploaded[world], size - staticUploaded[world],
+                          staticUploaded[world]);
+        staticUploaded[world] = size;
+    }
+    for (int range : removedRanges) {
+        const StaticRange& r = staticRanges[range];
+        if (r.offset[world] < staticUploaded[world]) {
+            buffer.updateData(bytes + r.offset[world], r.length[world], r.offset[world]);
+        }
+    }
+}
+
 void ObjectRenderer::renderStatic() {
     shader.use();
     RenderState::setViewMatrix(shader);
-    if (dirty) {
-        staticVertices = data[1].getSize() / (sizeof(float) * 3 + 4);
-        staticBuffer.setStaticData(data[1].getData(), data[1].getSize());
-        dirty = false;
+    uploadStaticRanges(0);
+    uploadStaticRanges(1);
+    removedRanges.clear();
+    dirty = false;
+
+    int world = Player::invertColors();
+    staticBuffer[world].drawQuads(data[1 + world].getSize() / (VERTEX_SIZE * 4));
+}
+
+void ObjectRenderer::beginStaticRange() {
+    staticRangeStart[0] = data[1].getSize();
+    staticRangeStart[1] = data[2].getSize();
+}
+
+void ObjectRenderer::bindStaticWorld(bool world) {
+    dataIndex = 1 + world;
+}
+
+int ObjectRenderer::endStaticRange() {
+    StaticRange r;
+    for (int world = 0; world < 2; world++) {
+        r.offset[world] = staticRangeStart[world];
+        r.length[world] = data[1 + world].getSize() - staticRangeStart[world];
     }
-    staticBuffer.drawTriangles(staticVertices);
-    data[1].clear();
+    staticRanges.push_back(r);
+    return staticRanges.size() - 1;
+}
+
+void ObjectRenderer::removeStaticRange(int range) {
+    if (range < 0 || range >= static_cast<int>(staticRanges.size())) {
+        return;
+    }
+    // zeroed vertices form degenerate quads which are not rasterized
+    const StaticRange& r = staticRanges[range];
+    for (int world = 0; world < 2; world++) {
+        char* bytes = const_cast<char*>(static_cast<const char*>(data[1 + world].getData()));
+        memset(bytes + r.offset[world], 0, r.length[world]);
+    }
+    removedRanges.push_back(range);
 }
 
 void ObjectRenderer::addTriangle(const Vector& x, const Vector& y, const Vector& z, Color c,
@@ -75,6 +155,7 @@ void ObjectRenderer::addTriangle(const Vector& x, const Vector& y, const Vector&
     data[dataIndex].add(x * scale).add(zLayer).add(xc);
     data[dataIndex].add(y * scale).add(zLayer).add(yc);
     data[dataIndex].add(z * scale).add(zLayer).add(zc);
+    data[dataIndex].add(z * scale).add(zLayer).add(zc);
 }
 
 void ObjectRenderer::addRectangle(const Vector& position, const Vector& size, Color c,
@@ -88,8 +169,6 @@ void ObjectRenderer::addRectangle(const Vector& position, const Vector& size, Co
     data[dataIndex].add(maxX).add(minY).add(zLayer).add(c);
     data[dataIndex].add(minX).add(maxY).add(zLayer).add(c);
     data[dataIndex].add(maxX).add(maxY).add(zLayer).add(c);
-    data[dataIndex].add(maxX).add(minY).add(zLayer).add(c);
-    data[dataIndex].add(minX).add(maxY).add(zLayer).add(c);
 }
 
 void ObjectRenderer::addRectangle(const Vector& position, const Vector& size, Color c) {
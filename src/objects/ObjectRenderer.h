@@ -11,6 +11,10 @@ namespace ObjectRenderer {
     void clearStaticBuffer();
     bool dirtyStaticBuffer();
     void renderStatic();
+    void beginStaticRange();
+    void bindStaticWorld(bool world);
+    int endStaticRange();
+    void removeStaticRange(int range);
     void render(const Matrix& view);
     void addTriangle(const Vector& x, const Vector& y, const Vector& z, Color c);
     void addTriangle(const Vector& x, const Vector& y, const Vector& z, Color c, float zLayer);
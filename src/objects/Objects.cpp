@@ -6,9 +6,11 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <typeinfo>
 #include <unordered_map>
 #include <vector>
 
+#include "PerfCounters.h"
 #include "Utils.h"
 #include "graphics/Font.h"
 #include "objects/ColorObject.h"
@@ -19,15 +21,135 @@
 #include "objects/MovingObject.h"
 #include "objects/MovingSwitchObject.h"
 #include "objects/ObjectRenderer.h"
+#include "objects/Triggers.h"
 #include "objects/TutorialObject.h"
 #include "objects/WindObject.h"
 #include "particles/ParticleSystem.h"
 #include "player/Player.h"
 
+// declared before the objects so that it outlives them
+static Arena levelArena;
+static Arena* allocationArena = nullptr;
+
+// awake objects of one concrete type, ticked and rendered without virtual calls, level objects
+// of the type are allocated back to back from the pool arena
+struct ObjectPool final {
+    const std::type_info* type;
+    void (*tick)(const std::vector<ObjectBase*>& objects);
+    void (*lateTick)(const std::vector<ObjectBase*>& objects);
+    void (*render)(const std::vector<ObjectBase*>& objects, float lag);
+    void (*lateRender)(const std::vector<ObjectBase*>& objects, float lag);
+    std::vector<ObjectBase*> active;
+    std::unique_ptr<Arena> arena;
+};
+
+// declared before the objects as well since the pools own arenas
+static std::vector<ObjectPool> pools;
+
 static std::vector<std::shared_ptr<ObjectBase>> objects;
 static std::vector<std::shared_ptr<ObjectBase>> prototypes;
 
+struct ObjectSlot final {
+    ObjectBase* object = nullptr;
+    uint32_t generation = 1;
+};
+
+static std::vector<ObjectSlot> slots;
+static std::vector<uint32_t> freeSlots;
+static bool destroyPending = false;
+
+// awake objects without a pool, driven through virtual calls
+static std::vector<ObjectBase*> activeUntyped;
+// rebuilt when objects are added, removed, put to sleep or woken up
+static bool activeDirty = true;
+
+// secondary indexes, rebuilt on the first query after objects were added, removed or edited
+static std::unordered_map<int, std::vector<ObjectBase*>> doorsByType;
+static std::unordered_map<int, int> keysByType;
+static std::vector<LevelDoorObject*> levelDoors;
+static bool indexDirty = true;
+
+static void markStaticMoved(ObjectBase& o) {
+    ObjectRenderer::removeStaticRange(o.staticRange);
+    o.staticRange = -1;
+    o.isStatic = false;
+}
+
+// every object in a pool has exactly the type T, so the qualified calls are not virtual
+template <typename T>
+static void tickPool(const std::vector<ObjectBase*>& objects) {
+    for (ObjectBase* base : objects) {
+        T* o = static_cast<T*>(base);
+        o->T::tick();
+        if (o->T::hasMoved() && o->isStatic) {
+            markStaticMoved(*o);
+        }
+    }
+}
+
+template <typename T>
+static void lateTickPool(const std::vector<ObjectBase*>& objects) {
+    for (ObjectBase* o : objects) {
+        static_cast<T*>(o)->T::lateTick();
+    }
+}
+
+template <typename T>
+static void renderPool(const std::vector<ObjectBase*>& objects, float lag) {
+    for (ObjectBase* o : objects) {
+        if (!o->isStatic) {
+            ObjectRenderer::bindBuffer(false);
+            static_cast<T*>(o)->T::render(lag);
+        }
+    }
+}
+
+template <typename T>
+static void lateRenderPool(const std::vector<ObjectBase*>& objects, float lag) {
+    for (ObjectBase* o : objects) {
+        if (!o->isStatic) {
+            ObjectRenderer::bindBuffer(false);
+            static_cast<T*>(o)->T::lateRender(lag);
+        }
+    }
+}
+
+template <typename T>
+static void addPool() {
+    pools.push_back({&typeid(T), tickPool<T>, lateTickPool<T>, renderPool<T>, lateRenderPool<T>,
+                     {}, std::make_unique<Arena>()});
+}
+
+static int findPool(const std::type_info& type) {
+    for (size_t i = 0; i < pools.size(); i++) {
+        if (*pools[i].type == type) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void getLevelAllocations(size_t& allocations, size_t& bytes) {
+    allocations = levelArena.getAllocations();
+    bytes = levelArena.getAllocatedBytes();
+    for (const ObjectPool& pool : pools) {
+        allocations += pool.arena->getAllocations();
+        bytes += pool.arena->getAllocatedBytes();
+    }
+}
+
 bool Objects::init() {
+    addPool<ColorObject>();
+    addPool<WindObject>();
+    addPool<MovingObject>();
+    addPool<ParticleSystem>();
+    addPool<MovingSwitchObject>();
+    addPool<KeyObject>();
+    addPool<DoorObject>();
+    addPool<LevelTagObject>();
+    addPool<LevelDoorObject>();
+    addPool<TutorialObject>();
+
     addPrototype(std::make_shared<ColorObject>(Vector(), Vector(1.0f, 1.0f), Ability::WALL_JUMP,
                                                Ability::DASH));
     addPrototype(std::make_shared<ColorObject>(Vector(), Vector(1.0f, 1.0f), Ability::DOUBLE_JUMP,
@@ -48,7 +170,7 @@ bool Objects::init() {
     addPrototype(std::make_shared<LevelTagObject>(Vector(), Vector(1.0f, 1.0f)));
     addPrototype(std::make_shared<LevelDoorObject>(Vector(), Vector(1.0f, 1.0f), 0));
     addPrototype(std::make_shared<TutorialObject>(Vector(), Vector(1.0f, 1.0f)));
-    return ObjectRenderer::init();
+    return false;
 }
 
 void Objects::addPrototype(std::shared_ptr<ObjectBase> prototype) {
@@ -67,14 +189,55 @@ size_t Objects::getPrototypeCount() {
     return prototypes.size();
 }
 
-void Objects::clear() {
-    for (size_t i = objects.size(); i > 0;) {
-        i--;
-        auto object = objects[i];
-        if (object->destroyOnLevelLoad) {
-            objects.erase(objects.begin() + i);
+static ObjectHandle acquireSlot(ObjectBase* object) {
+    uint32_t index = slots.size();
+    if (freeSlots.empty()) {
+        slots.emplace_back();
+    } else {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    slots[index].object = object;
+    return {index, slots[index].generation};
+}
+
+static void releaseSlot(ObjectHandle handle) {
+    ObjectSlot& slot = slots[handle.index];
+    slot.object = nullptr;
+    slot.generation++;
+    freeSlots.push_back(handle.index);
+}
+
+// removes all matching objects in one pass while keeping the order of the others
+template <typename F>
+static void removeObjects(F shouldRemove) {
+    size_t kept = 0;
+    for (size_t i = 0; i < objects.size(); i++) {
+        ObjectBase& o = *objects[i];
+        if (shouldRemove(o)) {
+            ObjectRenderer::removeStaticRange(o.staticRange);
+            releaseSlot(o.handle);
+        } else {
+            if (kept != i) {
+                objects[kept] = std::move(objects[i]);
+            }
+            kept++;
         }
     }
+    if (kept != objects.size()) {
+        objects.erase(objects.begin() + kept, objects.end());
+        Objects::markChanged();
+    }
+}
+
+void Objects::clear() {
+    // drop all static ranges so that the zeroed ranges of removed objects do not pile up
+    ObjectRenderer::clearStaticBuffer();
+    removeObjects([](const ObjectBase& o) { return o.destroyOnLevelLoad; });
+    levelArena.reset();
+    for (ObjectPool& pool : pools) {
+        pool.arena->reset();
+    }
 }
 
 void Objects::clearPrototypes() {
@@ -85,10 +248,44 @@ void Objects::add(std::shared_ptr<ObjectBase> o) {
 #ifndef NDEBUG
     o->initTileEditorData(o->getTileEditorProps());
 #endif
+    o->poolId = findPool(typeid(*o));
+    o->handle = acquireSlot(o.get());
     objects.emplace_back(o);
+    markChanged();
+}
+
+void Objects::beginLevelAllocations() {
+    allocationArena = &levelArena;
+}
+
+void Objects::endLevelAllocations() {
+    allocationArena = nullptr;
+    size_t allocations = 0;
+    size_t bytes = 0;
+    getLevelAllocations(allocations, bytes);
+    Utils::print("Level allocations: %zu (%zu bytes)\n", allocations, bytes);
+}
+
+Arena* Objects::getAllocationArena() {
+    return allocationArena;
+}
+
+Arena* Objects::getAllocationArena(const std::type_info& type) {
+    if (allocationArena == nullptr) {
+        return nullptr;
+    }
+    int pool = findPool(type);
+    return pool >= 0 ? pools[pool].arena.get() : allocationArena;
+}
+
+ObjectBase* Objects::get(ObjectHandle handle) {
+    if (handle.index >= slots.size() || slots[handle.index].generation != handle.generation) {
+        return nullptr;
+    }
+    return slots[handle.index].object;
 }
 
-std::vector<std::shared_ptr<ObjectBase>> Objects::getObjects() {
+const std::vector<std::shared_ptr<ObjectBase>>& Objects::getObjects() {
     return objects;
 }
 
@@ -156,53 +353,137 @@ bool Objects::hasWallCollision(const Vector& position, const Vector& size) {
     return false;
 }
 
-void Objects::handleCollision(const Vector& position, const Vector& size) {
+void Objects::saveState(std::vector<char>& state) {
+    state.clear();
     for (auto& o : objects) {
-        if (o->collidesWith(position, size)) {
-            o->onCollision();
+        o->saveState(state);
+    }
+    Triggers::saveState(state);
+}
+
+void Objects::loadState(const std::vector<char>& state) {
+    const char* data = state.data();
+    for (auto& o : objects) {
+        o->loadState(data);
+    }
+    Triggers::loadState(data);
+}
+
+void Objects::markChanged() {
+    activeDirty = true;
+    indexDirty = true;
+    Triggers::markDirty();
+}
+
+void Objects::markActiveDirty() {
+    activeDirty = true;
+}
+
+void Objects::markDestroyPending() {
+    destroyPending = true;
+}
+
+static void updateActiveObjects() {
+    if (!activeDirty) {
+        return;
+    }
+    for (ObjectPool& pool : pools) {
+        pool.active.clear();
+    }
+    activeUntyped.clear();
+    for (auto& o : objects) {
+        if (o->isSleeping()) {
+            continue;
+        }
+        if (o->poolId >= 0) {
+            pools[o->poolId].active.push_back(o.get());
+        } else {
+            activeUntyped.push_back(o.get());
         }
     }
+    activeDirty = false;
+}
+
+static size_t countActiveObjects() {
+    size_t active = activeUntyped.size();
+    for (const ObjectPool& pool : pools) {
+        active += pool.active.size();
+    }
+    return active;
 }
 
+// objects are ticked pool by pool in the order of Objects::init and in insertion order within a
+// pool, so an object may see a later added object of an earlier pool already ticked
 void Objects::tick() {
-    for (auto& o : objects) {
+    updateActiveObjects();
+    PerfCounters::addTickedObjects(countActiveObjects(), objects.size());
+    for (const ObjectPool& pool : pools) {
+        pool.tick(pool.active);
+    }
+    for (ObjectBase* o : activeUntyped) {
         o->tick();
-
         if (o->hasMoved() && o->isStatic) {
-            ObjectRenderer::clearStaticBuffer();
-            o->isStatic = false;
+            markStaticMoved(*o);
         }
     }
 
-    for (size_t i = objects.size(); i > 0;) {
-        i--;
-        auto object = objects[i];
-        if (object->shouldDestroy) {
-            objects.erase(objects.begin() + i);
-        }
+    // destroyed objects are collected and removed once per tick
+    if (destroyPending) {
+        destroyPending = false;
+        removeObjects([](const ObjectBase& o) { return o.shouldDestroy; });
     }
 }
 
 void Objects::lateTick() {
-    for (auto& o : objects) {
+    updateActiveObjects();
+    for (const ObjectPool& pool : pools) {
+        pool.lateTick(pool.active);
+    }
+    for (ObjectBase* o : activeUntyped) {
         o->lateTick();
     }
 }
 
 void Objects::render(float lag) {
-    for (auto& o : objects) {
-        if (o->isStatic && !ObjectRenderer::dirtyStaticBuffer()) {
-            continue;
+    PerfCounters::setLiveObjects(objects.size());
+    updateActiveObjects();
+    if (ObjectRenderer::dirtyStaticBuffer()) {
+        for (auto& o : objects) {
+            o->staticRange = -1;
         }
-        ObjectRenderer::bindBuffer(o->isStatic);
-        o->render(lag);
     }
     for (auto& o : objects) {
-        if (o->isStatic && !ObjectRenderer::dirtyStaticBuffer()) {
-            continue;
+        if (o->isStatic && o->staticRange == -1) {
+            // static objects keep their geometry for both worlds in their own range of the
+            // static buffers, a world switch only selects the other buffer
+            ObjectRenderer::beginStaticRange();
+            for (int world = 0; world < 2; world++) {
+                Player::setOverrideWorld(world);
+                ObjectRenderer::bindStaticWorld(world);
+                o->render(lag);
+                o->lateRender(lag);
+            }
+            Player::resetOverrideWorld();
+            o->staticRange = ObjectRenderer::endStaticRange();
+        }
+    }
+    for (const ObjectPool& pool : pools) {
+        pool.render(pool.active, lag);
+    }
+    for (ObjectBase* o : activeUntyped) {
+        if (!o->isStatic) {
+            ObjectRenderer::bindBuffer(false);
+            o->render(lag);
+        }
+    }
+    for (const ObjectPool& pool : pools) {
+        pool.lateRender(pool.active, lag);
+    }
+    for (ObjectBase* o : activeUntyped) {
+        if (!o->isStatic) {
+            ObjectRenderer::bindBuffer(false);
+            o->lateRender(lag);
         }
-        ObjectRenderer::bindBuffer(o->isStatic);
-        o->lateRender(lag);
     }
     ObjectRenderer::bindBuffer(false);
     ObjectRenderer::render();
@@ -212,6 +493,9 @@ void Objects::render(float lag) {
 void Objects::renderText(float lag) {
     Font::prepare();
     for (auto& o : objects) {
+        if (o->isSleeping()) {
+            continue;
+        }
         o->renderText(lag);
     }
 }
@@ -372,19 +656,43 @@ void Objects::reset() {
     }
 }
 
-std::shared_ptr<ObjectBase> Objects::findDoor(int type) {
+static void updateIndexes() {
+    if (!indexDirty) {
+        return;
+    }
+    doorsByType.clear();
+    keysByType.clear();
+    levelDoors.clear();
     for (auto& o : objects) {
-        if (o->isDoorOfType(type)) {
-            return o;
+        int doorType = o->getDoorType();
+        if (doorType >= 0) {
+            doorsByType[doorType].push_back(o.get());
+        }
+        int keyType = o->getKeyType();
+        if (keyType >= 0) {
+            keysByType[keyType]++;
+        }
+        if (typeid(*o) == typeid(LevelDoorObject)) {
+            levelDoors.push_back(static_cast<LevelDoorObject*>(o.get()));
         }
     }
-    return nullptr;
+    indexDirty = false;
+}
+
+Objects::Handle<ObjectBase> Objects::findDoor(int type) {
+    updateIndexes();
+    auto doors = doorsByType.find(type);
+    return doors == doorsByType.end() ? Handle<ObjectBase>()
+                                      : Handle<ObjectBase>(doors->second.front()->handle);
 }
 
 int Objects::countKeys(int type) {
-    int counter = 0;
-    for (auto& o : objects) {
-        counter += o->isKeyOfType(type);
-    }
-    return counter;
+    updateIndexes();
+    auto keys = keysByType.find(type);
+    return keys == keysByType.end() ? 0 : keys->second;
+}
+
+const std::vector<LevelDoorObject*>& Objects::getLevelDoors() {
+    updateIndexes();
+    return levelDoors;
 }
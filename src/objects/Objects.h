@@ -1,10 +1,14 @@
 #ifndef OBJECTS_H
 #define OBJECTS_H
 
+#include "Arena.h"
 #include "Object.h"
 #include <memory>
+#include <typeinfo>
 #include <vector>
 
+class LevelDoorObject;
+
 namespace Objects {
     bool init();
 
@@ -15,7 +19,41 @@ namespace Objects {
     std::shared_ptr<ObjectBase> getPrototype(int id);
 
     void add(std::shared_ptr<ObjectBase> o);
-    std::vector<std::shared_ptr<ObjectBase>> getObjects();
+    // objects created between these calls live in the level arena until the next clear
+    void beginLevelAllocations();
+    void endLevelAllocations();
+    Arena* getAllocationArena();
+    // pooled types get their own level arena so that their objects lie next to each other
+    Arena* getAllocationArena(const std::type_info& type);
+    template <typename T, typename... Args>
+    std::shared_ptr<T> create(Args&&... args) {
+        return std::allocate_shared<T>(ArenaAllocator<T>(getAllocationArena(typeid(T))),
+                                       std::forward<Args>(args)...);
+    }
+    // returns nullptr if the object was destroyed in the meantime
+    ObjectBase* get(ObjectHandle handle);
+
+    // typed object handle which does not keep the object alive, owners of an object keep a
+    // shared_ptr instead
+    template <typename T>
+    class Handle final {
+      public:
+        Handle() = default;
+        explicit Handle(ObjectHandle handle) : handle(handle) {
+        }
+        Handle(const std::shared_ptr<T>& o) : handle(o->handle) {
+        }
+
+        // returns nullptr if the object was destroyed in the meantime
+        T* get() const {
+            return static_cast<T*>(Objects::get(handle));
+        }
+
+      private:
+        ObjectHandle handle;
+    };
+
+    const std::vector<std::shared_ptr<ObjectBase>>& getObjects();
     std::shared_ptr<ObjectBase> instantiateObject(int prototypeIndex, Vector position = Vector());
     template <typename T>
     std::shared_ptr<T> instantiate(int prototypeId) {
@@ -39,8 +77,16 @@ namespace Objects {
     bool collidesWithAny(const Vector& position, const Vector& size);
     bool handleFaceCollision(const Vector& position, const Vector& size, Face face);
     bool hasWallCollision(const Vector& position, const Vector& size);
-    void handleCollision(const Vector& position, const Vector& size);
 
+    // gameplay state of all objects and triggers, only valid as long as no object is added or
+    // removed
+    void saveState(std::vector<char>& state);
+    void loadState(const std::vector<char>& state);
+
+    // call after changing the type, position or size of an existing object
+    void markChanged();
+    void markActiveDirty();
+    void markDestroyPending();
     void tick();
     void lateTick();
     void render(float lag);
@@ -69,8 +115,10 @@ namespace Objects {
 
     void saveObject(const char* path, ObjectBase& object);
     void reset();
-    std::shared_ptr<ObjectBase> findDoor(int type);
+    // returns an empty handle if the level has no door of this type
+    Handle<ObjectBase> findDoor(int type);
     int countKeys(int type);
+    const std::vector<LevelDoorObject*>& getLevelDoors();
 }
 
 #endif
@@ -0,0 +1,168 @@
+#include "Triggers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "objects/Objects.h"
+
+static constexpr float CELL_SIZE = 8.0f;
+
+// triggers do not keep their objects alive, destroyed objects resolve to nullptr
+struct Trigger final {
+    ObjectHandle object;
+    bool inside = false;
+    int lastVisit = -1;
+    int lastTouch = -1;
+};
+
+static std::vector<Trigger> triggers;
+// trigger index by object slot, -1 for slots without a trigger
+static std::vector<int> slotTriggers;
+static std::unordered_map<int64_t, std::vector<int>> cells;
+static std::vector<int> inside;
+static std::vector<int> touched;
+static bool dirty = true;
+static int updates = 0;
+
+static int getCell(float f) {
+    return static_cast<int>(floorf(f / CELL_SIZE));
+}
+
+static int64_t getCellKey(int x, int y) {
+    return (static_cast<int64_t>(x) << 32) ^ static_cast<uint32_t>(y);
+}
+
+// trigger bounds are fixed during play, key objects only move their render position, so the
+// index is rebuilt when objects are added or removed or Objects::markChanged reports an edit
+static void rebuild() {
+    std::vector<ObjectHandle> wasInside;
+    for (int index : inside) {
+        wasInside.push_back(triggers[index].object);
+    }
+    triggers.clear();
+    slotTriggers.clear();
+    cells.clear();
+    inside.clear();
+    for (auto& o : Objects::getObjects()) {
+        if (!o->isTrigger()) {
+            continue;
+        }
+        int index = triggers.size();
+        Trigger t;
+        t.object = o->handle;
+        if (std::find(wasInside.begin(), wasInside.end(), o->handle) != wasInside.end()) {
+            t.inside = true;
+            inside.push_back(index);
+        }
+        triggers.push_back(t);
+        if (o->handle.index >= slotTriggers.size()) {
+            slotTriggers.resize(o->handle.index + 1, -1);
+        }
+        slotTriggers[o->handle.index] = index;
+
+        Vector max = o->position + o->getSize();
+        for (int x = getCell(o->position.x); x <= getCell(max.x); x++) {
+            for (int y = getCell(o->position.y); y <= getCell(max.y); y++) {
+                cells[getCellKey(x, y)].push_back(index);
+            }
+        }
+    }
+    dirty = false;
+}
+
+void Triggers::markDirty() {
+    dirty = true;
+}
+
+void Triggers::update(const Vector& position, const Vector& size) {
+    if (dirty) {
+        rebuild();
+    }
+    updates++;
+    touched.clear();
+    Vector max = position + size;
+    for (int x = getCell(position.x); x <= getCell(max.x); x++) {
+        for (int y = getCell(position.y); y <= getCell(max.y); y++) {
+            auto cell = cells.find(getCellKey(x, y));
+            if (cell == cells.end()) {
+                continue;
+            }
+            for (int index : cell->second) {
+                // triggers spanning several cells are only tested once
+                Trigger& t = triggers[index];
+                if (t.lastVisit == updates) {
+                    continue;
+                }
+                t.lastVisit = updates;
+                ObjectBase* o = Objects::get(t.object);
+                if (o != nullptr && o->collidesWith(position, size)) {
+                    t.lastTouch = updates;
+                    touched.push_back(index);
+                }
+            }
+        }
+    }
+
+    // callbacks may add or destroy objects, the index is rebuilt on the next update
+    for (size_t i = inside.size(); i > 0;) {
+        i--;
+        Trigger& t = triggers[inside[i]];
+        if (t.lastTouch != updates) {
+            t.inside = false;
+            inside[i] = inside.back();
+            inside.pop_back();
+            ObjectBase* o = Objects::get(t.object);
+            if (o != nullptr) {
+                o->onTriggerExit();
+            }
+        }
+    }
+    for (int index : touched) {
+        Trigger& t = triggers[index];
+        // destruction is deferred to the object tick, so touched objects stay valid here
+        ObjectBase* o = Objects::get(t.object);
+        if (!t.inside) {
+            t.inside = true;
+            inside.push_back(index);
+            o->wake();
+            o->onTriggerEnter();
+        }
+        o->onTriggerStay();
+    }
+}
+
+void Triggers::saveState(std::vector<char>& state) {
+    if (dirty) {
+        rebuild();
+    }
+    saveStateValue(state, inside.size());
+    for (int index : inside) {
+        saveStateValue(state, triggers[index].object);
+    }
+}
+
+void Triggers::loadState(const char*& state) {
+    if (dirty) {
+        rebuild();
+    }
+    for (int index : inside) {
+        triggers[index].inside = false;
+    }
+    inside.clear();
+    size_t count = 0;
+    loadStateValue(state, count);
+    for (size_t i = 0; i < count; i++) {
+        ObjectHandle handle;
+        loadStateValue(state, handle);
+        if (Objects::get(handle) == nullptr || handle.index >= slotTriggers.size() ||
+            slotTriggers[handle.index] < 0) {
+            continue;
+        }
+        int index = slotTriggers[handle.index];
+        triggers[index].inside = true;
+        inside.push_back(index);
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef TRIGGERS_H
+#define TRIGGERS_H
+
+#include "math/Vector.h"
+
+#include <vector>
+
+// tracks which trigger objects the player overlaps and calls the enter, stay and exit callbacks
+namespace Triggers {
+    void markDirty();
+    void update(const Vector& position, const Vector& size);
+    // which triggers the player is inside, see ObjectBase::saveState
+    void saveState(std::vector<char>& state);
+    void loadState(const char*& state);
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include "Savegame.h"
 #include "TextUtils.h"
 #include "graphics/Font.h"
+#include "graphics/gl/Commands.h"
 #include "graphics/gl/Glew.h"
 #include "objects/Objects.h"
 #include "player/Player.h"
@@ -18,25 +19,22 @@
 static constexpr int DISPLAY_DELAY = 200;
 
 TutorialObject::TutorialObject(Vector position, Vector size)
-    : alpha(0.f), ticksUntilDisplayed(0), completed(false), wasCollidingInLastFrame(false) {
+    : alpha(0.f), ticksUntilDisplayed(0), completed(false), playerInside(false) {
     this->position = position;
     data = {};
     data.size = size;
 }
 
 TutorialObject::TutorialObject(TutorialObjectData data)
-    : alpha(0.f), ticksUntilDisplayed(0), completed(false), wasCollidingInLastFrame(false) {
+    : alpha(0.f), ticksUntilDisplayed(0), completed(false), playerInside(false) {
 }
 
 void TutorialObject::tick() {
     if (Game::isInSpeedrun()) {
+        sleep();
         return;
     }
-    bool colliding = Player::isColliding(*this);
-    if (colliding && !wasCollidingInLastFrame) {
-        ticksUntilDisplayed = DISPLAY_DELAY;
-    }
-    if (Player::isAllowedToMove() && colliding && shouldShowTutorial() && !completed &&
+    if (Player::isAllowedToMove() && playerInside && shouldShowTutorial() && !completed &&
         (ticksUntilDisplayed <= 0 || data.instant)) {
         completed = checkTutorialCompleted();
         alpha += 10.f;
@@ -46,10 +44,23 @@ void TutorialObject::tick() {
     alpha = std::max(std::min(alpha, 255), 0);
 
     ticksUntilDisplayed--;
-    wasCollidingInLastFrame = colliding;
+    // the player entering the object wakes it up again
+    if (!playerInside && alpha == 0) {
+        sleep();
+    }
+}
+
+bool TutorialObject::isTrigger() const {
+    return true;
+}
+
+void TutorialObject::onTriggerEnter() {
+    playerInside = true;
+    ticksUntilDisplayed = DISPLAY_DELAY;
 }
 
-void TutorialObject::onCollision() {
+void TutorialObject::onTriggerExit() {
+    playerInside = false;
 }
 
 bool TutorialObject::collidesWith(const Vector& pPosition, const Vector& pSize) const {
@@ -68,11 +79,11 @@ void TutorialObject::renderText(float lag) {
         char tutorialText[128];
         getTutorialText(tutorialText, 128);
         if (alpha < 150) {
-            glDepthMask(false);
+            GL::Commands::add([] { glDepthMask(false); });
             TextUtils::drawPopupObjectSpace(Player::getPosition() +
                                                 Vector(Player::getSize().x * 0.5f, 0.f),
                                             tutorialText, alpha);
-            glDepthMask(true);
+            GL::Commands::add([] { glDepthMask(true); });
         } else {
             TextUtils::drawPopupObjectSpace(Player::getPosition() +
                                                 Vector(Player::getSize().x * 0.5f, 0.f),
@@ -82,7 +93,7 @@ void TutorialObject::renderText(float lag) {
 }
 
 std::shared_ptr<ObjectBase> TutorialObject::clone() {
-    return std::make_shared<TutorialObject>(data);
+    return Objects::create<TutorialObject>(data);
 }
 
 #ifndef NDEBUG
@@ -31,7 +31,9 @@ class TutorialObject : public Object<TutorialObjectData> {
     TutorialObject(TutorialObjectData data);
 
     void tick() override;
-    void onCollision() override;
+    bool isTrigger() const override;
+    void onTriggerEnter() override;
+    void onTriggerExit() override;
     bool collidesWith(const Vector& position, const Vector& size) const override;
     Vector getSize() const override;
     std::shared_ptr<ObjectBase> clone() override;
@@ -49,7 +51,7 @@ class TutorialObject : public Object<TutorialObjectData> {
     int alpha;
     int ticksUntilDisplayed;
     bool completed;
-    bool wasCollidingInLastFrame;
+    bool playerInside;
 };
 
 #endif
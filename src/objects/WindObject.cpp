@@ -32,7 +32,11 @@ WindObject::WindObject(const Vector& position, const Vector& size, const Vector&
     data.force = force;
 }
 
-void WindObject::onCollision() {
+bool WindObject::isTrigger() const {
+    return true;
+}
+
+void WindObject::onTriggerStay() {
     if (Player::isGliding()) {
         Player::addForce(data.force);
     }
@@ -47,6 +51,7 @@ void WindObject::tick() {
 
 void WindObject::postInit() {
     particles = Objects::instantiateObject<ParticleSystem>("assets/particlesystems/wind.cmob");
+    particles->priority = ParticlePriority::AMBIENT;
     particles->data.minStartVelocity = data.force * 1.0f;
     particles->data.maxStartVelocity = data.force * 2.0f;
     particles->data.boxSize = Vector(abs(data.force.y) < 0.001f ? 0 : data.size.x,
@@ -134,7 +139,7 @@ void WindObject::renderEditor(float lag, bool inPalette) {
 }
 
 std::shared_ptr<ObjectBase> WindObject::clone() {
-    return std::make_shared<WindObject>(data);
+    return Objects::create<WindObject>(data);
 }
 
 #ifndef NDEBUG
@@ -21,7 +21,8 @@ class WindObject : public Object<WindObjectData> {
     ~WindObject();
 
     void postInit() override;
-    void onCollision() override;
+    bool isTrigger() const override;
+    void onTriggerStay() override;
     bool collidesWith(const Vector& position, const Vector& size) const override;
     std::shared_ptr<ObjectBase> clone() override;
     Vector getSize() const override;
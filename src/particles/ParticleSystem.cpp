@@ -1,9 +1,12 @@
 #include "ParticleSystem.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <imgui.h>
 #include <vector>
 
+#include "PerfCounters.h"
 #include "graphics/Buffer.h"
 #include "graphics/RenderState.h"
 #include "graphics/gl/Shader.h"
@@ -35,10 +38,85 @@ void ParticleRenderer::render() {
     shader.use();
     RenderState::setViewMatrix(shader);
     buffer.setStreamData(rawData.getData(), rawData.getSize());
-    buffer.drawTriangles(vertices);
+    buffer.drawQuads(vertices / 4);
 }
 
-ParticleSystem::ParticleSystem() {
+static constexpr int MAX_PARTICLES = 3000;
+// measured around Objects::lateTick where the particles simulate, not over the whole frame
+static constexpr int64_t LATE_TICK_NANOS = 3'000'000;
+static constexpr int MAX_LEVEL = 3;
+// a level is kept at least this long so that the effect of a change can be seen
+static constexpr int RAISE_TICKS = 30;
+static constexpr int LOWER_TICKS = 200;
+// indexed by level and priority
+static constexpr float EMISSION_SCALE[MAX_LEVEL + 1][3] = {
+    {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 0.5f}, {1.0f, 0.5f, 0.25f}, {1.0f, 0.25f, 0.0f}};
+static constexpr int LIFETIME_STEP[MAX_LEVEL + 1][3] = {{1, 1, 1}, {1, 1, 1}, {1, 1, 2}, {1, 2, 2}};
+
+static int budgetLevel = 0;
+static int ticksSinceChange = 0;
+static int liveParticles = 0;
+static int budgetHits = 0;
+static int degradations = 0;
+static int64_t tickStart = 0;
+
+static int64_t getNanos() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void ParticleBudget::beginTick() {
+    tickStart = getNanos();
+    liveParticles = 0;
+}
+
+void ParticleBudget::endTick() {
+    int64_t nanos = getNanos() - tickStart;
+    bool over = liveParticles > MAX_PARTICLES || nanos > LATE_TICK_NANOS;
+    bool under = liveParticles < MAX_PARTICLES * 3 / 4 && nanos < LATE_TICK_NANOS * 3 / 4;
+    ticksSinceChange++;
+    if (over) {
+        budgetHits++;
+        PerfCounters::addParticleBudgetHit();
+        if (budgetLevel < MAX_LEVEL && ticksSinceChange >= RAISE_TICKS) {
+            budgetLevel++;
+            degradations++;
+            PerfCounters::addParticleDegradation();
+            ticksSinceChange = 0;
+        }
+    } else if (under && budgetLevel > 0 && ticksSinceChange >= LOWER_TICKS) {
+        budgetLevel--;
+        ticksSinceChange = 0;
+    }
+}
+
+void ParticleBudget::addLiveParticles(int particles) {
+    liveParticles += particles;
+}
+
+float ParticleBudget::getEmissionScale(ParticlePriority priority) {
+    return EMISSION_SCALE[budgetLevel][static_cast<int>(priority)];
+}
+
+int ParticleBudget::getLifetimeStep(ParticlePriority priority) {
+    return LIFETIME_STEP[budgetLevel][static_cast<int>(priority)];
+}
+
+int ParticleBudget::getLevel() {
+    return budgetLevel;
+}
+
+int ParticleBudget::getBudgetHits() {
+    return budgetHits;
+}
+
+int ParticleBudget::getDegradations() {
+    return degradations;
+}
+
+ParticleSystem::ParticleSystem()
+    : triangles(Objects::getAllocationArena()), squares(Objects::getAllocationArena()),
+      diamonds(Objects::getAllocationArena()) {
 }
 
 ParticleSystem::ParticleSystem(Vector position) : ParticleSystem() {
@@ -53,6 +131,7 @@ ParticleSystem::ParticleSystem(const ParticleSystemData& data) : ParticleSystem(
 }
 
 void ParticleSystem::play() {
+    wake();
     this->playing = true;
     currentLifetime = 0.f;
 }
@@ -159,7 +238,8 @@ static void move(const ParticleSystemData& s, Particle& p) {
     }
 }
 
-void ParticleSystem::tickParticles(std::vector<Particle>& particles) {
+void ParticleSystem::tickParticles(ParticleList& particles) {
+    int lifetimeStep = ParticleBudget::getLifetimeStep(priority);
     Vector addVelocity = Vector(0, 0);
     if (data.followPlayer) {
         addVelocity = Player::getVelocity();
@@ -183,163 +263,273 @@ void ParticleSystem::tickParticles(std::vector<Particle>& particles) {
             p.lifetime += data.boxLifetimeLoss;
         }
 
-        p.lifetime++;
+        p.lifetime += lifetimeStep;
         if (p.lifetime >= data.maxLifetime) {
             particles[i] = particles.back();
             particles.erase(particles.begin() + (particles.size() - 1));
         }
     }
 }
-bool ParticleSystem::isSpiky(Face face) const {
-    return spiky[static_cast<int>(face)];
+// particles which do not interact with the world or the player can be moved many ticks at once,
+// box lifetime loss needs linear motion to find the ticks spent in the box
+bool ParticleSystem::canWarmStart() const {
+    return !data.enableCollision && !data.clampPositionInBounds && !data.followPlayer &&
+           data.attractSpeed == 0.0f && (data.boxLifetimeLoss == 0 || data.gravity == 0.0f);
 }
 
-void ParticleSystem::lateTick() {
-    if (data.followPlayer) {
-        position = Player::getCenter();
+// the ticks n between from and to in which start + velocity * n is strictly between min and max
+static void getTicksBetween(float start, float velocity, float min, float max, float& from,
+                            float& to) {
+    if (velocity == 0.0f) {
+        bool inside = start > min && start < max;
+        from = inside ? -INFINITY : 0.0f;
+        to = inside ? INFINITY : 0.0f;
+        return;
+    }
+    float a = (min - start) / velocity;
+    float b = (max - start) / velocity;
+    from = std::min(a, b);
+    to = std::max(a, b);
+}
+
+// the number of the next ticks after which tickParticles finds the particle in the box
+int ParticleSystem::getTicksInBox(const Particle& p, int ticks, bool moving) const {
+    if (!moving) {
+        return isInBox(p) ? ticks : 0;
+    }
+    bool useClampPos = abs(data.clampBoxSize.x) > 0 || abs(data.clampBoxSize.y) > 0;
+    Vector size = useClampPos ? data.clampBoxSize : data.boxSize;
+    float fromX, toX, fromY, toY;
+    getTicksBetween(p.position.x, p.velocity.x, position.x - size.x * 0.5f,
+                    position.x + size.x * 0.5f, fromX, toX);
+    getTicksBetween(p.position.y, p.velocity.y, position.y - size.y * 0.5f,
+                    position.y + size.y * 0.5f, fromY, toY);
+    float first = std::max(std::floor(std::max(fromX, fromY)) + 1.0f, 1.0f);
+    float last = std::min(std::ceil(std::min(toX, toY)) - 1.0f, static_cast<float>(ticks));
+    return last < first ? 0 : static_cast<int>(last - first) + 1;
+}
+
+ParticleList& ParticleSystem::getParticles() {
+    switch (data.type) {
+        case ParticleType::TRIANGLE: return triangles;
+        case ParticleType::DIAMOND: return diamonds;
+        default: return squares;
+    }
+}
+
+// same result as calling tickParticles the given times on the particles starting at first
+void ParticleSystem::advanceParticles(ParticleList& particles, int ticks, size_t first) {
+    bool moving = data.spawnPositionType != SpawnPositionType::BOX_EDGE_SPIKY;
+    for (size_t i = first; i < particles.size();) {
+        Particle& p = particles[i];
+        // the lifetime only grows, so a particle which dies on the way ends above the maximum
+        int lifetime = p.lifetime + ticks;
+        if (data.boxLifetimeLoss != 0) {
+            lifetime += (ticks - getTicksInBox(p, ticks, moving)) * data.boxLifetimeLoss;
+        }
+        if (lifetime >= data.maxLifetime) {
+            particles[i] = particles.back();
+            particles.pop_back();
+            continue;
+        }
+        if (moving) {
+            // every tick adds gravity to the velocity before moving
+            auto after = [&p, this](float n) {
+                Vector gravity(0.0f, data.gravity * n * (n + 1.0f) * 0.5f);
+                return p.position + p.velocity * n + gravity;
+            };
+            p.lastPosition = after(ticks - 1);
+            p.position = after(ticks);
+        } else {
+            p.lastPosition = p.position;
+        }
+        p.velocity[1] += data.gravity * ticks;
+        p.lifetime = lifetime;
+        i++;
+    }
+}
+
+void ParticleSystem::warmStart(int ticks) {
+    if (!canWarmStart()) {
+        for (int i = 0; i < ticks; i++) {
+            lateTick();
+        }
+        return;
+    }
+    advanceParticles(triangles, ticks);
+    advanceParticles(squares, ticks);
+    advanceParticles(diamonds, ticks);
+    // particles emitted before the last lifetime are already gone
+    int skipped = std::max(ticks - data.maxLifetime, 0);
+    currentLifetime += skipped;
+    ParticleList& particles = getParticles();
+    for (int i = skipped; i < ticks; i++) {
+        size_t first = particles.size();
+        if (isPlaying()) {
+            emit();
+        }
+        advanceParticles(particles, ticks - i, first);
+        currentLifetime++;
+    }
+    if (data.destroyOnEnd && data.duration > 0.f &&
+        currentLifetime >= data.duration + data.maxLifetime) {
+        destroy();
     }
+}
 
+bool ParticleSystem::isSpiky(Face face) const {
+    return spiky[static_cast<int>(face)];
+}
+
+void ParticleSystem::emit() {
     Vector particlePosition = position;
+    int emissionInterval = random.next(data.minEmissionInterval, data.maxEmissionInterval + 1);
+    if (emissionInterval <= 0 || currentLifetime % emissionInterval == 0) {
+        int emissionRate = random.next(data.minEmissionRate, data.maxEmissionRate + 1);
+        float scale = ParticleBudget::getEmissionScale(priority);
+        for (int i = 0; i < emissionRate; i++) {
+            if (scale < 1.0f && random.nextFloat() >= scale) {
+                continue;
+            }
+            if (data.spawnPositionType == SpawnPositionType::BOX_EDGE) {
+                Face spawnFace;
+                float value = random.nextFloat(0.0f, data.boxSize.x + data.boxSize.y);
+                if (value < data.boxSize.x) {
+                    spawnFace = (random.next(0, 2) == 0) ? Face::UP : Face::DOWN;
+                } else {
+                    spawnFace = (random.next(0, 2) == 0) ? Face::LEFT : Face::RIGHT;
+                }
 
-    if (isPlaying()) {
-        int emissionInterval = random.next(data.minEmissionInterval, data.maxEmissionInterval + 1);
-        if (emissionInterval <= 0 || currentLifetime % emissionInterval == 0) {
-            int emissionRate = random.next(data.minEmissionRate, data.maxEmissionRate + 1);
-            for (int i = 0; i < emissionRate; i++) {
-                if (data.spawnPositionType == SpawnPositionType::BOX_EDGE) {
-                    Face spawnFace;
-                    float value = random.nextFloat(0.0f, data.boxSize.x + data.boxSize.y);
-                    if (value < data.boxSize.x) {
-                        spawnFace = (random.next(0, 2) == 0) ? Face::UP : Face::DOWN;
-                    } else {
-                        spawnFace = (random.next(0, 2) == 0) ? Face::LEFT : Face::RIGHT;
-                    }
-
-                    if (spawnFace == Face::LEFT) {
-                        particlePosition.x = position.x - data.boxSize.x * 0.5f;
-                        particlePosition.y = position.y + random.nextFloat(-data.boxSize.y * 0.5f,
-                                                                           data.boxSize.y * 0.5f);
-                    } else if (spawnFace == Face::RIGHT) {
-                        particlePosition.x = position.x + data.boxSize.x * 0.5f;
-                        particlePosition.y = position.y + random.nextFloat(-data.boxSize.y * 0.5f,
-                                                                           data.boxSize.y * 0.5f);
-                    } else if (spawnFace == Face::UP) {
-                        particlePosition.x = position.x + random.nextFloat(-data.boxSize.x * 0.5f,
-                                                                           data.boxSize.x * 0.5f);
-                        particlePosition.y = position.y - data.boxSize.y * 0.5f;
-                    } else if (spawnFace == Face::DOWN) {
-                        particlePosition.x = position.x + random.nextFloat(-data.boxSize.x * 0.5f,
-                                                                           data.boxSize.x * 0.5f);
-                        particlePosition.y = position.y + data.boxSize.y * 0.5f;
-                    }
-                } else if (data.spawnPositionType == SpawnPositionType::BOX_EDGE_SPIKY) {
-                    Face spawnFace;
-                    float value = random.nextFloat(0.0f, data.boxSize.x + data.boxSize.y);
-                    if (value < data.boxSize.x) {
-                        spawnFace = (random.next(0, 2) == 0) ? Face::UP : Face::DOWN;
-                    } else {
-                        spawnFace = (random.next(0, 2) == 0) ? Face::LEFT : Face::RIGHT;
-                    }
-                    if (spawnFace == Face::LEFT) {
-                        particlePosition.x = position.x - data.boxSize.x * 0.5f;
-                        particlePosition.y =
-                            position.y +
-                            random.nextFloat(-data.boxSize.y * 0.5f +
-                                                 0.25f * isSpiky(Face::UP) * !isSpiky(Face::LEFT),
-                                             data.boxSize.y * 0.5f - 0.25f * isSpiky(Face::DOWN) *
-                                                                         !isSpiky(Face::LEFT));
-                        float base = std::abs(0.25f - fmod(particlePosition.y, 0.5f));
-                        particlePosition.x += base * isSpiky(Face::LEFT);
-                    } else if (spawnFace == Face::RIGHT) {
-                        particlePosition.x = position.x + data.boxSize.x * 0.5f;
-                        particlePosition.y =
-                            position.y +
-                            random.nextFloat(-data.boxSize.y * 0.5f +
-                                                 0.25f * isSpiky(Face::UP) * !isSpiky(Face::RIGHT),
-                                             data.boxSize.y * 0.5f - 0.25f * isSpiky(Face::DOWN) *
-                                                                         !isSpiky(Face::RIGHT));
-                        float base = std::abs(0.25f - fmod(particlePosition.y, 0.5f));
-                        particlePosition.x -= base * isSpiky(Face::RIGHT);
-                    } else if (spawnFace == Face::UP) {
-                        particlePosition.x =
-                            position.x +
-                            random.nextFloat(-data.boxSize.x * 0.5f +
-                                                 0.25f * isSpiky(Face::LEFT) * !isSpiky(Face::UP),
-                                             data.boxSize.x * 0.5f -
-                                                 0.25f * isSpiky(Face::RIGHT) * !isSpiky(Face::UP));
-                        particlePosition.y = position.y - data.boxSize.y * 0.5f;
-                        float base = std::abs(0.25f - fmod(particlePosition.x, 0.5f));
-                        particlePosition.y += base * isSpiky(Face::UP);
-                    } else if (spawnFace == Face::DOWN) {
-                        particlePosition.x =
-                            position.x +
-                            random.nextFloat(-data.boxSize.x * 0.5f +
-                                                 0.25f * isSpiky(Face::LEFT) * !isSpiky(Face::DOWN),
-                                             data.boxSize.x * 0.5f - 0.25f * isSpiky(Face::RIGHT) *
-                                                                         !isSpiky(Face::DOWN));
-                        particlePosition.y = position.y + data.boxSize.y * 0.5f;
-                        float base = std::abs(0.25f - fmod(particlePosition.x, 0.5f));
-                        particlePosition.y -= base * isSpiky(Face::DOWN);
-                    }
-                } else if (data.spawnPositionType == SpawnPositionType::BOX) {
-                    particlePosition.x = position.x + random.nextFloat(-data.boxSize.x * 0.5f,
-                                                                       data.boxSize.x * 0.5f);
+                if (spawnFace == Face::LEFT) {
+                    particlePosition.x = position.x - data.boxSize.x * 0.5f;
                     particlePosition.y = position.y + random.nextFloat(-data.boxSize.y * 0.5f,
                                                                        data.boxSize.y * 0.5f);
-                } else if (data.spawnPositionType == SpawnPositionType::WIND) {
-                    int line = random.next(0, 2);
-                    int xSign = data.minStartVelocity.x < 0 ? -1 : 1;
-                    int ySign = data.minStartVelocity.y < 0 ? -1 : 1;
-                    Vector box =
-                        Vector(abs(data.boxSize.x) > 0 ? data.boxSize.x : data.clampBoxSize.x,
-                               abs(data.boxSize.y) > 0 ? data.boxSize.y : data.clampBoxSize.y);
-                    if (data.boxSize.y == 0 || (data.boxSize.x != 0 && line == 0)) {
-                        particlePosition.x =
-                            position.x + random.nextFloat(-box.x * 0.5f, box.x * 0.5f);
-                        particlePosition.y = position.y + -ySign * box.y * 0.5f;
-                    } else {
-                        particlePosition.x = position.x + -xSign * box.x * 0.5f;
-                        particlePosition.y =
-                            position.y + random.nextFloat(-box.y * 0.5f, box.y * 0.5f);
-                    }
+                } else if (spawnFace == Face::RIGHT) {
+                    particlePosition.x = position.x + data.boxSize.x * 0.5f;
+                    particlePosition.y = position.y + random.nextFloat(-data.boxSize.y * 0.5f,
+                                                                       data.boxSize.y * 0.5f);
+                } else if (spawnFace == Face::UP) {
+                    particlePosition.x = position.x + random.nextFloat(-data.boxSize.x * 0.5f,
+                                                                       data.boxSize.x * 0.5f);
+                    particlePosition.y = position.y - data.boxSize.y * 0.5f;
+                } else if (spawnFace == Face::DOWN) {
+                    particlePosition.x = position.x + random.nextFloat(-data.boxSize.x * 0.5f,
+                                                                       data.boxSize.x * 0.5f);
+                    particlePosition.y = position.y + data.boxSize.y * 0.5f;
                 }
-
-                float startVelocityX =
-                    random.nextFloat(data.minStartVelocity.x, data.maxStartVelocity.x);
-                float startVelocityY;
-                if (data.symmetrical && data.minStartVelocity.x != 0 &&
-                    data.minStartVelocity.y != 0) {
-                    startVelocityY = data.minStartVelocity.y +
-                                     ((startVelocityX - data.minStartVelocity.x) /
-                                      (data.maxStartVelocity.x - data.minStartVelocity.x) *
-                                      (data.maxStartVelocity.y - data.minStartVelocity.y));
+            } else if (data.spawnPositionType == SpawnPositionType::BOX_EDGE_SPIKY) {
+                Face spawnFace;
+                float value = random.nextFloat(0.0f, data.boxSize.x + data.boxSize.y);
+                if (value < data.boxSize.x) {
+                    spawnFace = (random.next(0, 2) == 0) ? Face::UP : Face::DOWN;
                 } else {
-                    startVelocityY =
-                        random.nextFloat(data.minStartVelocity.y, data.maxStartVelocity.y);
+                    spawnFace = (random.next(0, 2) == 0) ? Face::LEFT : Face::RIGHT;
+                }
+                if (spawnFace == Face::LEFT) {
+                    particlePosition.x = position.x - data.boxSize.x * 0.5f;
+                    particlePosition.y =
+                        position.y +
+                        random.nextFloat(-data.boxSize.y * 0.5f +
+                                             0.25f * isSpiky(Face::UP) * !isSpiky(Face::LEFT),
+                                         data.boxSize.y * 0.5f - 0.25f * isSpiky(Face::DOWN) *
+                                                                     !isSpiky(Face::LEFT));
+                    float base = std::abs(0.25f - fmod(particlePosition.y, 0.5f));
+                    particlePosition.x += base * isSpiky(Face::LEFT);
+                } else if (spawnFace == Face::RIGHT) {
+                    particlePosition.x = position.x + data.boxSize.x * 0.5f;
+                    particlePosition.y =
+                        position.y +
+                        random.nextFloat(-data.boxSize.y * 0.5f +
+                                             0.25f * isSpiky(Face::UP) * !isSpiky(Face::RIGHT),
+                                         data.boxSize.y * 0.5f - 0.25f * isSpiky(Face::DOWN) *
+                                                                     !isSpiky(Face::RIGHT));
+                    float base = std::abs(0.25f - fmod(particlePosition.y, 0.5f));
+                    particlePosition.x -= base * isSpiky(Face::RIGHT);
+                } else if (spawnFace == Face::UP) {
+                    particlePosition.x =
+                        position.x +
+                        random.nextFloat(-data.boxSize.x * 0.5f +
+                                             0.25f * isSpiky(Face::LEFT) * !isSpiky(Face::UP),
+                                         data.boxSize.x * 0.5f -
+                                             0.25f * isSpiky(Face::RIGHT) * !isSpiky(Face::UP));
+                    particlePosition.y = position.y - data.boxSize.y * 0.5f;
+                    float base = std::abs(0.25f - fmod(particlePosition.x, 0.5f));
+                    particlePosition.y += base * isSpiky(Face::UP);
+                } else if (spawnFace == Face::DOWN) {
+                    particlePosition.x =
+                        position.x +
+                        random.nextFloat(-data.boxSize.x * 0.5f +
+                                             0.25f * isSpiky(Face::LEFT) * !isSpiky(Face::DOWN),
+                                         data.boxSize.x * 0.5f - 0.25f * isSpiky(Face::RIGHT) *
+                                                                     !isSpiky(Face::DOWN));
+                    particlePosition.y = position.y + data.boxSize.y * 0.5f;
+                    float base = std::abs(0.25f - fmod(particlePosition.x, 0.5f));
+                    particlePosition.y -= base * isSpiky(Face::DOWN);
                 }
-                Vector startVelocity(startVelocityX, startVelocityY);
-                switch (data.type) {
-                    case ParticleType::TRIANGLE:
-                        spawnTriangle(particlePosition, startVelocity);
-                        break;
-                    case ParticleType::SQUARE: spawnSquare(particlePosition, startVelocity); break;
-                    case ParticleType::DIAMOND:
-                        spawnDiamond(particlePosition, startVelocity);
-                        break;
+            } else if (data.spawnPositionType == SpawnPositionType::BOX) {
+                particlePosition.x = position.x + random.nextFloat(-data.boxSize.x * 0.5f,
+                                                                   data.boxSize.x * 0.5f);
+                particlePosition.y = position.y + random.nextFloat(-data.boxSize.y * 0.5f,
+                                                                   data.boxSize.y * 0.5f);
+            } else if (data.spawnPositionType == SpawnPositionType::WIND) {
+                int line = random.next(0, 2);
+                int xSign = data.minStartVelocity.x < 0 ? -1 : 1;
+                int ySign = data.minStartVelocity.y < 0 ? -1 : 1;
+                Vector box =
+                    Vector(abs(data.boxSize.x) > 0 ? data.boxSize.x : data.clampBoxSize.x,
+                           abs(data.boxSize.y) > 0 ? data.boxSize.y : data.clampBoxSize.y);
+                if (data.boxSize.y == 0 || (data.boxSize.x != 0 && line == 0)) {
+                    particlePosition.x = position.x + random.nextFloat(-box.x * 0.5f, box.x * 0.5f);
+                    particlePosition.y = position.y + -ySign * box.y * 0.5f;
+                } else {
+                    particlePosition.x = position.x + -xSign * box.x * 0.5f;
+                    particlePosition.y = position.y + random.nextFloat(-box.y * 0.5f, box.y * 0.5f);
                 }
             }
+
+            float startVelocityX =
+                random.nextFloat(data.minStartVelocity.x, data.maxStartVelocity.x);
+            float startVelocityY;
+            if (data.symmetrical && data.minStartVelocity.x != 0 && data.minStartVelocity.y != 0) {
+                startVelocityY = data.minStartVelocity.y +
+                                 ((startVelocityX - data.minStartVelocity.x) /
+                                  (data.maxStartVelocity.x - data.minStartVelocity.x) *
+                                  (data.maxStartVelocity.y - data.minStartVelocity.y));
+            } else {
+                startVelocityY = random.nextFloat(data.minStartVelocity.y, data.maxStartVelocity.y);
+            }
+            Vector startVelocity(startVelocityX, startVelocityY);
+            switch (data.type) {
+                case ParticleType::TRIANGLE: spawnTriangle(particlePosition, startVelocity); break;
+                case ParticleType::SQUARE: spawnSquare(particlePosition, startVelocity); break;
+                case ParticleType::DIAMOND: spawnDiamond(particlePosition, startVelocity); break;
+            }
         }
     }
+}
+
+void ParticleSystem::lateTick() {
+    if (data.followPlayer) {
+        position = Player::getCenter();
+    }
+
+    if (isPlaying()) {
+        emit();
+    }
 
     tickParticles(triangles);
     tickParticles(squares);
     tickParticles(diamonds);
+    ParticleBudget::addLiveParticles(getParticleCount());
 
     currentLifetime++;
 
     if (data.destroyOnEnd && data.duration > 0.f &&
         currentLifetime >= data.duration + data.maxLifetime) {
         destroy();
+    } else if (!data.destroyOnEnd && !isPlaying() && getParticleCount() == 0) {
+        // stopped and empty systems have nothing to do until they are played again
+        sleep();
     }
 }
 
@@ -367,7 +557,8 @@ void ParticleSystem::renderTriangles(float lag) {
         rawData.add(particlePosition + Vector(0.0f, a - h)).add(z).add(c);
         rawData.add(particlePosition + Vector(-0.5 * size, a)).add(z).add(c);
         rawData.add(particlePosition + Vector(0.5 * size, a)).add(z).add(c);
-        vertices += 3;
+        rawData.add(particlePosition + Vector(0.5 * size, a)).add(z).add(c);
+        vertices += 4;
     }
 }
 
@@ -389,9 +580,7 @@ void ParticleSystem::renderSquares(float lag) {
         rawData.add(leftBottom).add(z).add(c);
         rawData.add(rightTop).add(z).add(c);
         rawData.add(particlePosition + Vector(halfSize, halfSize)).add(z).add(c);
-        rawData.add(leftBottom).add(z).add(c);
-        rawData.add(rightTop).add(z).add(c);
-        vertices += 6;
+        vertices += 4;
     }
 }
 
@@ -410,13 +599,12 @@ void ParticleSystem::renderDiamonds(float lag) {
         rawData.add(particlePosition + Vector(0.5f * size, 0.f)).add(z).add(c);
         rawData.add(particlePosition + Vector(-0.5f * size, 0.f)).add(z).add(c);
         rawData.add(particlePosition + Vector(0.f, 0.5f * size)).add(z).add(c);
-        rawData.add(particlePosition + Vector(0.5f * size, 0.f)).add(z).add(c);
-        rawData.add(particlePosition + Vector(-0.5f * size, 0.f)).add(z).add(c);
-        vertices += 6;
+        vertices += 4;
     }
 }
 
 void ParticleSystem::render(float lag) {
+    PerfCounters::addLiveParticles(getParticleCount());
     renderTriangles(lag);
     renderSquares(lag);
     renderDiamonds(lag);
@@ -444,7 +632,9 @@ bool ParticleSystem::isInBox(const Particle& particle) const {
 }
 
 std::shared_ptr<ObjectBase> ParticleSystem::clone() {
-    return std::make_shared<ParticleSystem>(data);
+    std::shared_ptr<ParticleSystem> copy = Objects::create<ParticleSystem>(data);
+    copy->priority = priority;
+    return copy;
 }
 
 #ifndef NDEBUG
@@ -509,6 +699,10 @@ bool ParticleSystem::allowSaving() const {
     return false;
 }
 
+int ParticleSystem::getParticleCount() const {
+    return triangles.size() + squares.size() + diamonds.size();
+}
+
 bool ParticleSystem::isPlaying() const {
     return playing && (data.duration <= 0.f || currentLifetime < data.duration);
 }
@@ -4,6 +4,7 @@
 #include <array>
 #include <vector>
 
+#include "Arena.h"
 #include "graphics/Color.h"
 #include "math/Random.h"
 #include "math/Vector.h"
@@ -19,6 +20,9 @@ enum class SpawnPositionType { CENTER, BOX_EDGE, BOX, WIND, BOX_EDGE_SPIKY };
 
 enum class Layer { BEHIND_TILEMAP, OVER_TILEMAP };
 
+// lower priorities are degraded first when the particle budget is exceeded
+enum class ParticlePriority { HIGH, NORMAL, AMBIENT };
+
 struct ParticleSystemData final {
     int duration = 0;
     ParticleType type = ParticleType::SQUARE;
@@ -57,6 +61,9 @@ struct Particle final {
     int lifetime;
 };
 
+// level systems keep their particles in the level arena
+typedef std::vector<Particle, ArenaAllocator<Particle>> ParticleList;
+
 class ParticleSystem : public Object<ParticleSystemData> {
   public:
     ParticleSystem();
@@ -65,6 +72,8 @@ class ParticleSystem : public Object<ParticleSystemData> {
     void play();
     void stop();
     void clear();
+    // fills the system as if it had been ticked for the given ticks
+    void warmStart(int ticks);
     void lateTick() override;
     void render(float lag) override;
 #ifndef NDEBUG
@@ -80,16 +89,24 @@ class ParticleSystem : public Object<ParticleSystemData> {
 
     bool isPlaying() const;
     void setSpikes(const std::array<bool, 4>& spikes);
+    int getParticleCount() const;
+
+    ParticlePriority priority = ParticlePriority::NORMAL;
 
   private:
-    std::vector<Particle> triangles;
-    std::vector<Particle> squares;
-    std::vector<Particle> diamonds;
+    ParticleList triangles;
+    ParticleList squares;
+    ParticleList diamonds;
 
     void renderTriangles(float lag);
     void renderSquares(float lag);
     void renderDiamonds(float lag);
-    void tickParticles(std::vector<Particle>& particles);
+    void tickParticles(ParticleList& particles);
+    void advanceParticles(ParticleList& particles, int ticks, size_t first = 0);
+    bool canWarmStart() const;
+    int getTicksInBox(const Particle& particle, int ticks, bool moving) const;
+    ParticleList& getParticles();
+    void emit();
 
     void spawnTriangle(const Vector& position, const Vector& velocity);
     void spawnSquare(const Vector& position, const Vector& velocity);
@@ -111,4 +128,18 @@ namespace ParticleRenderer {
     void render();
 }
 
+// degrades low priority systems when the live particles or the time between beginTick and
+// endTick, which wrap Objects::lateTick, exceed the budget
+namespace ParticleBudget {
+    void beginTick();
+    void endTick();
+    void addLiveParticles(int particles);
+
+    float getEmissionScale(ParticlePriority priority);
+    int getLifetimeStep(ParticlePriority priority);
+    int getLevel();
+    int getBudgetHits();
+    int getDegradations();
+}
+
 #endif
@@ -18,8 +18,8 @@
 #include "graphics/gl/Shader.h"
 #include "graphics/gl/VertexBuffer.h"
 #include "math/Vector.h"
-#include "objects/ObjectRenderer.h"
 #include "objects/Objects.h"
+#include "objects/Triggers.h"
 #include "player/Player.h"
 #include "sound/SoundManager.h"
 #include "tilemap/Tilemap.h"
@@ -50,6 +50,8 @@ static std::shared_ptr<ParticleSystem> walljumpParticles;
 static std::shared_ptr<ParticleSystem> gliderParticles;
 static bool useOverrideColor = false;
 static Color overrideColor;
+static bool useOverrideWorld = false;
+static bool overrideWorld = false;
 static std::shared_ptr<ParticleSystem> colorSwitchParticles;
 static std::shared_ptr<ParticleSystem> loseAbilityParticles;
 
@@ -129,7 +131,11 @@ bool Player::init() {
         return true;
     }
     buffer.init(GL::VertexBuffer::Attributes().addVector3().addRGBA());
+    initParticles();
+    return false;
+}
 
+void Player::initParticles() {
     deathParticles =
         Objects::instantiateObject<ParticleSystem>("assets/particlesystems/death.cmob");
     deathParticles->destroyOnLevelLoad = false;
@@ -179,7 +185,14 @@ bool Player::init() {
         Objects::instantiateObject<ParticleSystem>("assets/particlesystems/glider.cmob");
     gliderParticles->destroyOnLevelLoad = false;
 
-    return false;
+    // player feedback is never degraded by the particle budget
+    for (ParticleSystem* p :
+         {deathParticles.get(), walkParticles.get(), wallStickParticles.get(), dashParticles.get(),
+          jumpParticlesLeft.get(), jumpParticlesRight.get(), jumpParticles.get(),
+          walljumpParticlesLeft.get(), walljumpParticlesRight.get(), walljumpParticles.get(),
+          colorSwitchParticles.get(), loseAbilityParticles.get(), gliderParticles.get()}) {
+        p->priority = ParticlePriority::HIGH;
+    }
 }
 
 static bool wasColliding(Face face) {
@@ -347,7 +360,7 @@ static void tickCollision() {
         }
     }
 
-    Objects::handleCollision(position, data.size);
+    Triggers::update(position, data.size);
 }
 
 static void move() {
@@ -427,7 +440,6 @@ void Player::restart() {
         SoundManager::switchMusic();
     }
     Game::setBackgroundParticleColor();
-    ObjectRenderer::clearStaticBuffer();
     deaths++;
 }
 
@@ -481,6 +493,15 @@ Color Player::getOverrideColor() {
     return overrideColor;
 }
 
+void Player::setOverrideWorld(bool world) {
+    overrideWorld = world;
+    useOverrideWorld = true;
+}
+
+void Player::resetOverrideWorld() {
+    useOverrideWorld = false;
+}
+
 void Player::resetOverrideColor() {
     useOverrideColor = false;
 }
@@ -557,12 +578,14 @@ bool Player::isWallSticking() {
 }
 
 bool Player::invertColors() {
+    if (useOverrideWorld) {
+        return overrideWorld;
+    }
     return worldType;
 }
 
 void Player::toggleWorld() {
     worldType = !worldType;
-    Tilemap::forceReload();
     if (!hasAbility(Ability::NONE)) {
         PlayerParticles::setParticleColors();
         PlayerParticles::setParticlePosition(colorSwitchParticles, 0, 0, 0, 0);
@@ -570,6 +593,80 @@ void Player::toggleWorld() {
     }
 }
 
+void Player::saveState(State& state) {
+    state.position = position;
+    state.lastPosition = lastPosition;
+    state.baseVelocity = baseVelocity;
+    state.lastBaseVelocity = lastBaseVelocity;
+    state.velocity = data.velocity;
+    state.acceleration = data.acceleration;
+    state.abilities[0] = abilities[0];
+    state.abilities[1] = abilities[1];
+    state.collision = collision;
+    state.lastCollision = lastCollision;
+    state.fakeGrounded = fakeGrounded;
+    state.leftWall = leftWall;
+    state.rightWall = rightWall;
+    state.leftWallBuffer = leftWallBuffer;
+    state.rightWallBuffer = rightWallBuffer;
+    state.worldType = worldType;
+    state.allowedToMove = allowedToMove;
+    state.gravityEnabled = gravityEnabled;
+    state.wallJumpCooldown = wallJumpCooldown;
+    state.jumpTicks = jumpTicks;
+    state.wallJumpTicks = wallJumpTicks;
+    state.wallJumpDirection = wallJumpDirection;
+    state.leftWallJumpCooldown = leftWallJumpCooldown;
+    state.rightWallJumpCooldown = rightWallJumpCooldown;
+    state.jumpBufferTicks = jumpBufferTicks;
+    state.leftWallJumpBuffer = leftWallJumpBuffer;
+    state.rightWallJumpBuffer = rightWallJumpBuffer;
+    state.dashTicks = dashTicks;
+    state.dashCoolDown = dashCoolDown;
+    state.dashVelocity = dashVelocity;
+    state.dashDirection = dashDirection;
+    state.dashUseable = dashUseable;
+    state.jumpCount = jumpCount;
+    state.dead = dead;
+}
+
+void Player::loadState(const State& state) {
+    position = state.position;
+    lastPosition = state.lastPosition;
+    baseVelocity = state.baseVelocity;
+    lastBaseVelocity = state.lastBaseVelocity;
+    data.velocity = state.velocity;
+    data.acceleration = state.acceleration;
+    abilities[0] = state.abilities[0];
+    abilities[1] = state.abilities[1];
+    collision = state.collision;
+    lastCollision = state.lastCollision;
+    fakeGrounded = state.fakeGrounded;
+    leftWall = state.leftWall;
+    rightWall = state.rightWall;
+    leftWallBuffer = state.leftWallBuffer;
+    rightWallBuffer = state.rightWallBuffer;
+    worldType = state.worldType;
+    allowedToMove = state.allowedToMove;
+    gravityEnabled = state.gravityEnabled;
+    wallJumpCooldown = state.wallJumpCooldown;
+    jumpTicks = state.jumpTicks;
+    wallJumpTicks = state.wallJumpTicks;
+    wallJumpDirection = state.wallJumpDirection;
+    leftWallJumpCooldown = state.leftWallJumpCooldown;
+    rightWallJumpCooldown = state.rightWallJumpCooldown;
+    jumpBufferTicks = state.jumpBufferTicks;
+    leftWallJumpBuffer = state.leftWallJumpBuffer;
+    rightWallJumpBuffer = state.rightWallJumpBuffer;
+    dashTicks = state.dashTicks;
+    dashCoolDown = state.dashCoolDown;
+    dashVelocity = state.dashVelocity;
+    dashDirection = state.dashDirection;
+    dashUseable = state.dashUseable;
+    jumpCount = state.jumpCount;
+    dead = state.dead;
+}
+
 static void tickIdleAndRunAnimation() {
     if (!Player::isColliding(Face::DOWN)) {
         idle = false;
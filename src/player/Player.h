@@ -1,6 +1,8 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
+#include <array>
+
 #include "Ability.h"
 #include "math/Vector.h"
 #include "objects/Object.h"
@@ -8,7 +10,46 @@
 #include "player/Face.h"
 
 namespace Player {
+    // everything the physics of a tick depend on, cosmetic state is not included
+    struct State final {
+        Vector position;
+        Vector lastPosition;
+        Vector baseVelocity;
+        Vector lastBaseVelocity;
+        Vector velocity;
+        Vector acceleration;
+        Ability abilities[2];
+        std::array<bool, FACES> collision;
+        std::array<bool, FACES> lastCollision;
+        int fakeGrounded;
+        bool leftWall;
+        bool rightWall;
+        int leftWallBuffer;
+        int rightWallBuffer;
+        bool worldType;
+        bool allowedToMove;
+        bool gravityEnabled;
+        int wallJumpCooldown;
+        int jumpTicks;
+        int wallJumpTicks;
+        Vector wallJumpDirection;
+        int leftWallJumpCooldown;
+        int rightWallJumpCooldown;
+        int jumpBufferTicks;
+        int leftWallJumpBuffer;
+        int rightWallJumpBuffer;
+        int dashTicks;
+        int dashCoolDown;
+        Vector dashVelocity;
+        float dashDirection;
+        bool dashUseable;
+        int jumpCount;
+        int dead;
+    };
+
     bool init();
+    // the part of init which needs no render context
+    void initParticles();
 
     bool isColliding(Face face);
     bool isColliding(const ObjectBase& o);
@@ -29,6 +70,8 @@ namespace Player {
     void setOverrideColor(Color color);
     Color getOverrideColor();
     void resetOverrideColor();
+    void setOverrideWorld(bool world);
+    void resetOverrideWorld();
     void setHidden(bool hidden);
     bool invertColors();
     void toggleWorld();
@@ -47,6 +90,9 @@ namespace Player {
     bool isGrounded();
     bool isWallSticking();
 
+    void saveState(State& state);
+    void loadState(const State& state);
+
     void tick();
     void render(float lag);
     void renderImGui();
@@ -0,0 +1,72 @@
+#include "MusicStream.h"
+
+#include "Utils.h"
+
+MusicStream::MusicStream() : file(), stream(nullptr) {
+}
+
+MusicStream::~MusicStream() {
+    close();
+}
+
+bool MusicStream::open(const char* path, int frequency, Uint16 format, int channels) {
+    close();
+    if (ov_fopen(path, &file) != 0) {
+        Utils::printError("could not open music '%s'\n", path);
+        return true;
+    }
+    vorbis_info* info = ov_info(&file, -1);
+    stream = SDL_NewAudioStream(AUDIO_S16SYS, info->channels, info->rate, format, channels,
+                                frequency);
+    if (stream == nullptr) {
+        Utils::printError("could not convert music '%s': %s\n", path, SDL_GetError());
+        ov_clear(&file);
+        return true;
+    }
+    return false;
+}
+
+void MusicStream::close() {
+    if (stream == nullptr) {
+        return;
+    }
+    SDL_FreeAudioStream(stream);
+    stream = nullptr;
+    ov_clear(&file);
+}
+
+void MusicStream::restart() {
+    if (stream == nullptr) {
+        return;
+    }
+    ov_pcm_seek(&file, 0);
+    SDL_AudioStreamClear(stream);
+}
+
+void MusicStream::mix(Uint8* out, int length, Uint16 format, int volume) {
+    if (stream == nullptr) {
+        return;
+    }
+    char decoded[4096];
+    while (SDL_AudioStreamAvailable(stream) < length) {
+        int section = 0;
+        long bytes = ov_read(&file, decoded, sizeof(decoded), SDL_BYTEORDER == SDL_BIG_ENDIAN, 2,
+                             1, &section);
+        if (bytes == 0) {
+            if (ov_pcm_seek(&file, 0) != 0) {
+                break;
+            }
+        } else if (bytes > 0) {
+            SDL_AudioStreamPut(stream, decoded, bytes);
+        } else if (bytes != OV_HOLE) {
+            break;
+        }
+    }
+    if (buffer.size() < static_cast<size_t>(length)) {
+        buffer.resize(length);
+    }
+    int read = SDL_AudioStreamGet(stream, buffer.data(), length);
+    if (read > 0 && volume > 0) {
+        SDL_MixAudioFormat(out, buffer.data(), format, read, volume);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef MUSIC_STREAM_H
+#define MUSIC_STREAM_H
+
+#include <SDL.h>
+#include <vector>
+#include <vorbis/vorbisfile.h>
+
+#include "NonCopyable.h"
+
+// an ogg file which is decoded in small pieces while it is played
+class MusicStream final : private NonCopyable {
+  public:
+    MusicStream();
+    ~MusicStream();
+
+    bool open(const char* path, int frequency, Uint16 format, int channels);
+    void close();
+    void restart();
+    // adds the next length bytes to out, the stream loops at its end
+    void mix(Uint8* out, int length, Uint16 format, int volume);
+
+  private:
+    OggVorbis_File file;
+    SDL_AudioStream* stream;
+    std::vector<Uint8> buffer;
+};
+
+#endif
@@ -2,18 +2,72 @@
 
 #include "Arguments.h"
 #include "Utils.h"
+#include "sound/MusicStream.h"
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <mutex>
 
 const static int maxMusicVolume = MIX_MAX_VOLUME / 4;
 const static int soundEffectsGroup = 1;
 const static int maxChannels = 16;
+const static int maxBufferSize = 4096;
+// underruns within the window until the buffer size is doubled
+const static int maxUnderruns = 8;
+const static Uint32 underrunWindowMillis = 10'000;
 static int curMusicChannel = SoundManager::lightSoundID;
-static bool muted = false;
+static std::atomic<bool> muted{false};
 static int musicVolume = maxMusicVolume;
 
+static int bufferSize = maxBufferSize;
+static int frequency = 0;
+static Uint16 deviceFormat = 0;
+static int deviceChannels = 0;
+static int bytesPerFrame = 0;
+static Uint64 lastMix = 0;
+static std::atomic<int> mixFrames{0};
+static std::atomic<int> underruns{0};
+static int seenUnderruns = 0;
+static std::deque<Uint32> underrunTimes;
+
 SoundManager::SoundObject soundArray[Sound::MAX];
 
+// music is streamed on the audio thread, light and dark are always read together so that the
+// world switch stays sample aligned
+struct Music final {
+    MusicStream stream;
+    int volume = 0;
+    bool playing = false;
+};
+static Music music[3];
+static std::mutex musicMutex;
+
+static Music* getMusic(int soundId) {
+    switch (soundId) {
+        case Sound::LIGHT_BG: return music;
+        case Sound::DARK_BG: return music + 1;
+        case Sound::TITLE: return music + 2;
+        default: return nullptr;
+    }
+}
+
+static void mixMusic(void*, Uint8* stream, int length) {
+    std::lock_guard<std::mutex> lock(musicMutex);
+    for (Music& m : music) {
+        if (m.playing) {
+            m.stream.mix(stream, length, deviceFormat, muted ? 0 : m.volume);
+        }
+    }
+}
+
+static void startMusic(Music& m, int volume) {
+    m.stream.restart();
+    m.volume = volume;
+    m.playing = true;
+}
+
 static int getIdFromChannel(int channel) {
     for (int i = 0; i < Sound::MAX; i++) {
         if (soundArray[i].channel == channel) {
@@ -41,22 +95,94 @@ static void channelDone(int channel) {
     soundArray[ID].channel = -1;
 }
 
-bool SoundManager::init() {
-    if (Arguments::muted) {
-        return false;
+// runs on the audio thread, a mix which comes later than two buffers means the device starved
+static void postMix(void*, Uint8*, int length) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    int frames = length / bytesPerFrame;
+    if (lastMix != 0 && frequency > 0) {
+        double elapsed = static_cast<double>(now - lastMix) / SDL_GetPerformanceFrequency();
+        if (elapsed > 2.0 * frames / frequency) {
+            underruns++;
+        }
     }
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096) == -1) {
+    lastMix = now;
+    mixFrames = frames;
+}
+
+static bool openAudio(int size) {
+    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, size) == -1) {
         Utils::printError("SDL Mixer failed to initialise: %s\n", SDL_GetError());
-        Arguments::muted = true;
         return true;
     }
+    Mix_QuerySpec(&frequency, &deviceFormat, &deviceChannels);
+    bytesPerFrame = std::max(deviceChannels * (SDL_AUDIO_BITSIZE(deviceFormat) / 8), 1);
+    bufferSize = size;
+    lastMix = 0;
+    mixFrames = 0;
+    seenUnderruns = underruns;
+    underrunTimes.clear();
 
     Mix_AllocateChannels(maxChannels);
-    Mix_GroupChannels(darkSoundID + 1, maxChannels - 1, soundEffectsGroup);
+    Mix_GroupChannels(SoundManager::darkSoundID + 1, maxChannels - 1, soundEffectsGroup);
     Mix_ChannelFinished(channelDone);
+    Mix_SetPostMix(postMix, nullptr);
+    Mix_HookMusic(mixMusic, nullptr);
     return false;
 }
 
+bool SoundManager::init() {
+    if (Arguments::muted) {
+        return false;
+    }
+    int size = 256;
+    while (size < Arguments::audioBufferSize && size < maxBufferSize) {
+        size *= 2;
+    }
+    if (openAudio(size)) {
+        Arguments::muted = true;
+        return true;
+    }
+    return false;
+}
+
+void SoundManager::update() {
+    if (Arguments::muted) {
+        return;
+    }
+    static bool reported = false;
+    if (!reported && mixFrames > 0) {
+        reported = true;
+        Utils::print("audio buffer: %d frames, latency: %.1fms\n", bufferSize,
+                     getLatencyMillis());
+    }
+    Uint32 now = SDL_GetTicks();
+    for (; seenUnderruns < underruns; seenUnderruns++) {
+        underrunTimes.push_back(now);
+    }
+    while (!underrunTimes.empty() && now - underrunTimes.front() > underrunWindowMillis) {
+        underrunTimes.pop_front();
+    }
+    if (static_cast<int>(underrunTimes.size()) < maxUnderruns || bufferSize >= maxBufferSize) {
+        return;
+    }
+    Utils::print("audio underruns with %d frames, increasing buffer\n", bufferSize);
+    Mix_HaltChannel(-1);
+    Mix_CloseAudio();
+    if (openAudio(bufferSize * 2)) {
+        Arguments::muted = true;
+        return;
+    }
+    reported = false;
+}
+
+float SoundManager::getLatencyMillis() {
+    return frequency > 0 ? 1000.0f * mixFrames / frequency : 0.0f;
+}
+
+int SoundManager::getUnderruns() {
+    return underruns;
+}
+
 static bool play(int soundId, int channel, int volume, int loops) {
     if (soundArray[soundId].sound == nullptr) {
         return true;
@@ -81,8 +207,10 @@ bool SoundManager::playMusic() {
     if (Arguments::muted) {
         return false;
     }
-    if (play(Sound::LIGHT_BG, curMusicChannel, musicVolume, -1)) return true;
-    if (play(Sound::DARK_BG, 1 - curMusicChannel, 0, -1)) return true;
+    std::lock_guard<std::mutex> lock(musicMutex);
+    bool light = curMusicChannel == lightSoundID;
+    startMusic(*getMusic(Sound::LIGHT_BG), light ? musicVolume : 0);
+    startMusic(*getMusic(Sound::DARK_BG), light ? 0 : musicVolume);
     return false;
 }
 
@@ -110,6 +238,11 @@ bool SoundManager::playContinuousSound(int soundId) {
     if (Arguments::muted) {
         return false;
     }
+    if (Music* m = getMusic(soundId)) {
+        std::lock_guard<std::mutex> lock(musicMutex);
+        startMusic(*m, soundArray[soundId].defaultVolume);
+        return false;
+    }
     soundArray[soundId].channel = findFreeChannel();
     return play(soundId, soundArray[soundId].channel, -1, -1);
 }
@@ -133,19 +266,25 @@ static void loadSound(Sound::Sound s, const char* path, int volume) {
     }
 }
 
+static void loadMusic(Sound::Sound s, const char* path, int volume) {
+    soundArray[s].defaultVolume = volume;
+    std::lock_guard<std::mutex> lock(musicMutex);
+    getMusic(s)->stream.open(path, frequency, deviceFormat, deviceChannels);
+}
+
 bool SoundManager::loadSounds() {
     if (Arguments::muted) {
         return false;
     }
-    loadSound(Sound::LIGHT_BG, "assets/sounds/light.ogg", musicVolume);
-    loadSound(Sound::DARK_BG, "assets/sounds/dark.ogg", musicVolume);
+    loadMusic(Sound::LIGHT_BG, "assets/sounds/light.ogg", musicVolume);
+    loadMusic(Sound::DARK_BG, "assets/sounds/dark.ogg", musicVolume);
     loadSound(Sound::WORLD_SWITCH, "assets/sounds/switch.ogg", MIX_MAX_VOLUME / 4);
     loadSound(Sound::JUMP, "assets/sounds/jump.ogg", MIX_MAX_VOLUME / 2);
     loadSound(Sound::DASH, "assets/sounds/dash.ogg", MIX_MAX_VOLUME / 2);
     loadSound(Sound::WIND, "assets/sounds/wind.ogg", MIX_MAX_VOLUME / 2);
     loadSound(Sound::COLLECT, "assets/sounds/collect.ogg", MIX_MAX_VOLUME / 2);
     loadSound(Sound::DEATH, "assets/sounds/death.ogg", MIX_MAX_VOLUME / 4);
-    loadSound(Sound::TITLE, "assets/sounds/title.ogg", MIX_MAX_VOLUME / 2);
+    loadMusic(Sound::TITLE, "assets/sounds/title.ogg", MIX_MAX_VOLUME / 2);
     loadSound(Sound::DOOR, "assets/sounds/door.ogg", MIX_MAX_VOLUME / 4);
     loadSound(Sound::TELEPORT, "assets/sounds/teleport.ogg", MIX_MAX_VOLUME / 4);
     loadSound(Sound::EXPLODE, "assets/sounds/explode.ogg", MIX_MAX_VOLUME / 3);
@@ -159,6 +298,11 @@ void SoundManager::setVolume(int soundId, int volume) {
     if (Arguments::muted) {
         return;
     }
+    if (Music* m = getMusic(soundId)) {
+        std::lock_guard<std::mutex> lock(musicMutex);
+        m->volume = volume;
+        return;
+    }
     Mix_Volume(soundArray[soundId].channel, volume);
 }
 
@@ -173,6 +317,11 @@ void SoundManager::stopSound(int soundId) {
     if (Arguments::muted) {
         return;
     }
+    if (Music* m = getMusic(soundId)) {
+        std::lock_guard<std::mutex> lock(musicMutex);
+        m->playing = false;
+        return;
+    }
     Mix_HaltChannel(soundArray[soundId].channel);
 }
 
@@ -213,10 +362,18 @@ bool SoundManager::soundPlaying(int soundId) {
     if (Arguments::muted) {
         return false;
     }
+    if (Music* m = getMusic(soundId)) {
+        std::lock_guard<std::mutex> lock(musicMutex);
+        return m->playing;
+    }
     return soundArray[soundId].playing;
 }
 
 void SoundManager::quit() {
+    if (!Arguments::muted) {
+        Utils::print("audio latency: %.1fms, underruns: %d\n", getLatencyMillis(),
+                     getUnderruns());
+    }
     Arguments::muted = true;
     // clean up our resources
     for (SoundObject object : soundArray) {
@@ -226,7 +383,11 @@ void SoundManager::quit() {
     }
 
     // quit SDL_mixer
+    Mix_HookMusic(nullptr, nullptr);
     Mix_CloseAudio();
+    for (Music& m : music) {
+        m.stream.close();
+    }
 }
 
 void SoundManager::mute() {
@@ -34,6 +34,10 @@ namespace SoundManager {
     };
 
     bool init();
+    // may reopen the device, called once per frame from the main thread
+    void update();
+    float getLatencyMillis();
+    int getUnderruns();
     bool playMusic();
     bool playSoundEffect(int soundId);
     bool playContinuousSound(int soundId);
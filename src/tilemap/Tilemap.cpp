@@ -1,36 +1,67 @@
 #include "Tilemap.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <fstream>
 #include <vector>
 
+#include "Arguments.h"
 #include "Tiles.h"
 #include "graphics/Buffer.h"
 #include "graphics/RenderState.h"
 #include "graphics/gl/Shader.h"
+#include "graphics/gl/Texture.h"
 #include "graphics/gl/VertexBuffer.h"
 #include "player/Player.h"
 
 static GL::Shader shader;
 static GL::VertexBuffer buffer;
 static GL::VertexBuffer background;
-static int vertices = 0;
-static int verticesTransparent = 0;
+static GL::Shader textureShader;
+static GL::Texture tileTexture;
+// tiles changed since the last upload, uploaded while rendering since ticks may run without GL
+static std::vector<int> changedTiles;
 static bool dirty = true;
 static int width = 0;
 static int height = 0;
 static std::vector<char> tiles;
 
+static constexpr int VERTEX_SIZE = sizeof(float) * 3 + 4;
+static constexpr int CHUNK_SIZE = 16;
+// room for a row of full spikes so that small edits keep the chunk in its range
+static constexpr int CHUNK_SLACK = CHUNK_SIZE * 32;
+static constexpr int LAYERS = 2;
+
+// each layer keeps the ranges of all chunks in one region so that it is drawn with one call
+struct Chunk final {
+    int offset[LAYERS] = {0, 0};
+    int capacity[LAYERS] = {0, 0};
+    int vertices[LAYERS] = {0, 0};
+    bool dirty = false;
+};
+static std::vector<Chunk> chunks;
+static int chunksX = 0;
+static bool chunksDirty = false;
+static int layerOffset[LAYERS] = {0, 0};
+static int layerVertices[LAYERS] = {0, 0};
+
 bool Tilemap::init(int w, int h) {
     if (shader.compile({"assets/shaders/tilemap.vs", "assets/shaders/tilemap.fs"})) {
         return true;
     }
+    if (Arguments::tileTexture && textureShader.compile({"assets/shaders/tilemapTexture.vs",
+                                                         "assets/shaders/tilemapTexture.fs"})) {
+        return true;
+    }
     width = w;
     height = h;
     tiles.resize(width * height, 0);
     buffer.init(GL::VertexBuffer::Attributes().addVector3().addRGBA());
     background.init(GL::VertexBuffer::Attributes().addVector3().addRGBA());
+    if (Arguments::tileTexture) {
+        tileTexture.init(false);
+    }
     return false;
 }
 
@@ -50,6 +81,7 @@ void Tilemap::setSize(int newWidth, int newHeight) {
     width = newWidth;
     height = newHeight;
     tiles.resize(newWidth * newHeight);
+    dirty = true;
 }
 
 const Tile& Tilemap::getTile(int x, int y) {
@@ -59,63 +91,205 @@ const Tile& Tilemap::getTile(int x, int y) {
     return Tiles::get(tiles[width * y + x]);
 }
 
+static void markChunkDirty(int x, int y) {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return;
+    }
+    chunks[(y / CHUNK_SIZE) * chunksX + x / CHUNK_SIZE].dirty = true;
+    chunksDirty = true;
+}
+
 void Tilemap::setTile(int x, int y, const Tile& tile) {
     tiles[width * y + x] = tile.getId();
-    dirty = true;
+    if (dirty) {
+        return;
+    } else if (Arguments::tileTexture) {
+        changedTiles.push_back(width * y + x);
+        return;
+    }
+    // neighbour aware spikes depend on the adjacent tiles
+    markChunkDirty(x, y);
+    markChunkDirty(x - 1, y);
+    markChunkDirty(x + 1, y);
+    markChunkDirty(x, y - 1);
+    markChunkDirty(x, y + 1);
+}
+
+// zeroed vertices form degenerate quads which are not rasterized
+static void addEmptyVertices(Buffer& data, int vertices) {
+    static constexpr char EMPTY[VERTEX_SIZE] = {};
+    for (int i = 0; i < vertices; i++) {
+        data.add(EMPTY);
+    }
+}
+
+static void buildChunk(Buffer (&data)[LAYERS], Chunk& chunk, int chunkX, int chunkY) {
+    // the mesh is baked in light world colors and inverted by the shader
+    Player::setOverrideWorld(false);
+    int start[LAYERS] = {data[0].getSize(), data[1].getSize()};
+    int minX = chunkX * CHUNK_SIZE;
+    int minY = chunkY * CHUNK_SIZE;
+    int maxX = std::min(minX + CHUNK_SIZE, width);
+    int maxY = std::min(minY + CHUNK_SIZE, height);
+    for (int x = minX; x < maxX; x++) {
+        for (int y = minY; y < maxY; y++) {
+            Tilemap::getTile(x, y).render(data[0], x, y, -0.2f);
+            Tilemap::getTile(x, y).renderTransparent(data[1], x, y, -0.5f);
+        }
+    }
+    for (int layer = 0; layer < LAYERS; layer++) {
+        chunk.vertices[layer] = (data[layer].getSize() - start[layer]) / VERTEX_SIZE;
+    }
+    chunk.dirty = false;
+    Player::resetOverrideWorld();
+}
+
+static void buildChunks() {
+    static Buffer data[LAYERS];
+    data[0].clear();
+    data[1].clear();
+
+    chunksX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    int chunksY = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunks.assign(chunksX * chunksY, Chunk());
+
+    int offset[LAYERS] = {0, 0};
+    for (int y = 0; y < chunksY; y++) {
+        for (int x = 0; x < chunksX; x++) {
+            Chunk& chunk = chunks[y * chunksX + x];
+            buildChunk(data, chunk, x, y);
+            for (int layer = 0; layer < LAYERS; layer++) {
+                chunk.offset[layer] = offset[layer];
+                chunk.capacity[layer] = chunk.vertices[layer] + CHUNK_SLACK;
+                offset[layer] += chunk.capacity[layer];
+                addEmptyVertices(data[layer], CHUNK_SLACK);
+            }
+        }
+    }
+    layerOffset[0] = 0;
+    layerOffset[1] = offset[0];
+    layerVertices[0] = offset[0];
+    layerVertices[1] = offset[1];
+    for (Chunk& chunk : chunks) {
+        chunk.offset[1] += layerOffset[1];
+    }
+
+    buffer.setStaticData(nullptr, (offset[0] + offset[1]) * VERTEX_SIZE);
+    buffer.updateData(data[0].getData(), data[0].getSize(), 0);
+    buffer.updateData(data[1].getData(), data[1].getSize(), layerOffset[1] * VERTEX_SIZE);
+    chunksDirty = false;
+}
+
+static bool updateChunks() {
+    static Buffer data[LAYERS];
+    for (int i = 0; i < static_cast<int>(chunks.size()); i++) {
+        Chunk& chunk = chunks[i];
+        if (!chunk.dirty) {
+            continue;
+        }
+        int oldVertices[LAYERS] = {chunk.vertices[0], chunk.vertices[1]};
+        data[0].clear();
+        data[1].clear();
+        buildChunk(data, chunk, i % chunksX, i / chunksX);
+        for (int layer = 0; layer < LAYERS; layer++) {
+            if (chunk.vertices[layer] > chunk.capacity[layer]) {
+                return true;
+            }
+            // clear the vertices a shrinking chunk leaves behind
+            addEmptyVertices(data[layer], oldVertices[layer] - chunk.vertices[layer]);
+            if (data[layer].getSize() == 0) {
+                continue;
+            }
+            buffer.updateData(data[layer].getData(), data[layer].getSize(),
+                              chunk.offset[layer] * VERTEX_SIZE);
+        }
+    }
+    chunksDirty = false;
+    return false;
 }
 
 static void prepareRendering() {
     if (!dirty) {
+        for (int tile : changedTiles) {
+            tileTexture.setByte(tile % width, tile / width, tiles[tile]);
+        }
+        changedTiles.clear();
+        if (chunksDirty && updateChunks()) {
+            buildChunks();
+        }
         return;
     }
     static Buffer data;
     data.clear();
 
+    Player::setOverrideWorld(false);
     Color c = Tiles::AIR.getColor();
+    Player::resetOverrideWorld();
     data.add(0.0f).add(0.0f).add(0.0f).add(c);
     data.add(static_cast<float>(width)).add(0.0f).add(0.0f).add(c);
     data.add(0.0f).add(static_cast<float>(height)).add(0.0f).add(c);
     data.add(static_cast<float>(width)).add(static_cast<float>(height)).add(0.0f).add(c);
-    data.add(static_cast<float>(width)).add(0.0f).add(0.0f).add(c);
-    data.add(0.0f).add(static_cast<float>(height)).add(0.0f).add(c);
     background.setStaticData(data.getData(), data.getSize());
     data.clear();
 
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            Tilemap::getTile(x, y).render(data, x, y, -0.2f);
-        }
-    }
-    vertices = data.getSize() / (sizeof(float) * 3 + 4);
-    for (int x = 0; x < width; x++) {
-        for (int y = 0; y < height; y++) {
-            Tilemap::getTile(x, y).renderTransparent(data, x, y, -0.5f);
-        }
+    if (Arguments::tileTexture) {
+        tileTexture.setByteData(width, height, tiles.data());
+        changedTiles.clear();
+        dirty = false;
+        return;
     }
-    verticesTransparent = data.getSize() / (sizeof(float) * 3 + 4) - vertices;
-    buffer.setStaticData(data.getData(), data.getSize());
+
+    buildChunks();
     dirty = false;
 }
 
 void Tilemap::renderBackground() {
     shader.use();
     RenderState::setViewMatrix(shader);
+    shader.setInt("invert", Player::invertColors());
     prepareRendering();
-    background.drawTriangles(6);
+    background.drawQuads(1);
+}
+
+static void renderTexture(int layer, float z) {
+    textureShader.use();
+    RenderState::setViewMatrix(textureShader);
+    prepareRendering();
+    tileTexture.bindTo(0);
+    textureShader.setInt("tiles", 0);
+    textureShader.setInt("tileCount", Tiles::getCount());
+    textureShader.setInt("layer", layer);
+    textureShader.setFloat("depth", z);
+    textureShader.setVector("mapSize", Tilemap::getSize());
+    textureShader.setColor("wallColor", Tiles::WALL.getColor());
+    textureShader.setColor("spikeColor", Tiles::SPIKES.getColor());
+    textureShader.setColor("goalColor", Tiles::GOAL_LEFT.getColor());
+    textureShader.setColor("defaultColor", Tiles::get(-1).getColor());
+    background.drawQuads(1);
 }
 
 void Tilemap::render() {
+    if (Arguments::tileTexture) {
+        renderTexture(0, -0.2f);
+        return;
+    }
     shader.use();
     RenderState::setViewMatrix(shader);
+    shader.setInt("invert", Player::invertColors());
     prepareRendering();
-    buffer.drawTriangles(vertices);
+    buffer.drawQuads(layerVertices[0] / 4, layerOffset[0]);
 }
 
 void Tilemap::renderForeground() {
+    if (Arguments::tileTexture) {
+        renderTexture(1, -0.5f);
+        return;
+    }
     shader.use();
     RenderState::setViewMatrix(shader);
+    shader.setInt("invert", Player::invertColors());
     prepareRendering();
-    buffer.drawTriangles(verticesTransparent, vertices);
+    buffer.drawQuads(layerVertices[1] / 4, layerOffset[1]);
 }
 
 void Tilemap::forceReload() {
@@ -146,8 +146,6 @@ void STBTE_DRAW_RECT(int x0, int y0, int x1, int y1, unsigned int color) {
     renderBuffer.add(maxX).add(minY).add(zLayer).add(color);
     renderBuffer.add(minX).add(maxY).add(zLayer).add(color);
     renderBuffer.add(maxX).add(maxY).add(zLayer).add(color);
-    renderBuffer.add(maxX).add(minY).add(zLayer).add(color);
-    renderBuffer.add(minX).add(maxY).add(zLayer).add(color);
     zLayer -= 0.0002f;
 }
 
@@ -167,8 +165,6 @@ void STBTE_DRAW_TILE(int x0, int y0, unsigned short id, int highlight, float* da
         renderBuffer.add(maxX).add(minY).add(zLayer).add(color);
         renderBuffer.add(minX).add(maxY).add(zLayer).add(color);
         renderBuffer.add(maxX).add(maxY).add(zLayer).add(color);
-        renderBuffer.add(maxX).add(minY).add(zLayer).add(color);
-        renderBuffer.add(minX).add(maxY).add(zLayer).add(color);
     } else if (id < OBJECT_ID_OFFSET) {
         if (data == nullptr) {
             float minX = tileSpaceX;
@@ -180,8 +176,6 @@ void STBTE_DRAW_TILE(int x0, int y0, unsigned short id, int highlight, float* da
             renderBuffer.add(maxX).add(minY).add(zLayer).add(color);
             renderBuffer.add(minX).add(maxY).add(zLayer).add(color);
             renderBuffer.add(maxX).add(maxY).add(zLayer).add(color);
-            renderBuffer.add(maxX).add(minY).add(zLayer).add(color);
-            renderBuffer.add(minX).add(maxY).add(zLayer).add(color);
         }
 
         Tiles::get(id).renderEditor(renderBuffer, tileSpaceX, tileSpaceY, zLayer);
@@ -329,7 +323,7 @@ void TilemapEditor::render() {
 
     int vertices = renderBuffer.getSize() / (sizeof(float) * 3 + 4);
     buffer.setStreamData(renderBuffer.getData(), renderBuffer.getSize());
-    buffer.drawTriangles(vertices);
+    buffer.drawQuads(vertices / 4);
 
     RenderState::enableBlending();
     ObjectRenderer::bindBuffer(false);
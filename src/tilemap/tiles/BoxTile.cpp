@@ -13,6 +13,4 @@ void BoxTile::render(Buffer& buffer, float x, float y, float z) const {
     buffer.add(maxX).add(minY).add(z).add(color);
     buffer.add(minX).add(maxY).add(z).add(color);
     buffer.add(maxX).add(maxY).add(z).add(color);
-    buffer.add(maxX).add(minY).add(z).add(color);
-    buffer.add(minX).add(maxY).add(z).add(color);
 }
\ No newline at end of file
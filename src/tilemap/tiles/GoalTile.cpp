@@ -35,8 +35,6 @@ void GoalTile::renderTransparent(Buffer& buffer, float x, float y, float z) cons
     buffer.add(x).add(y + 1.0f).add(z).add(color[face == Face::LEFT || face == Face::DOWN]);
     buffer.add(x + 1.0f).add(y).add(z).add(color[face == Face::RIGHT || face == Face::UP]);
     buffer.add(x + 1.0f).add(y + 1.0f).add(z).add(color[face == Face::RIGHT || face == Face::DOWN]);
-    buffer.add(x).add(y + 1.0f).add(z).add(color[face == Face::LEFT || face == Face::DOWN]);
-    buffer.add(x + 1.0f).add(y).add(z).add(color[face == Face::RIGHT || face == Face::UP]);
 }
 
 void GoalTile::renderEditor(Buffer& buffer, float x, float y, float z) const {
@@ -45,8 +43,6 @@ void GoalTile::renderEditor(Buffer& buffer, float x, float y, float z) const {
     buffer.add(x).add(y + 1.0f).add(z).add(color[face == Face::LEFT || face == Face::DOWN]);
     buffer.add(x + 1.0f).add(y).add(z).add(color[face == Face::RIGHT || face == Face::UP]);
     buffer.add(x + 1.0f).add(y + 1.0f).add(z).add(color[face == Face::RIGHT || face == Face::DOWN]);
-    buffer.add(x).add(y + 1.0f).add(z).add(color[face == Face::LEFT || face == Face::DOWN]);
-    buffer.add(x + 1.0f).add(y).add(z).add(color[face == Face::RIGHT || face == Face::UP]);
 }
 
 void GoalTile::onLoad(int x, int y) const {
@@ -13,8 +13,6 @@ void SpawnTile::renderEditor(Buffer& buffer, float x, float y, float z) const {
     buffer.add(maxX).add(minY).add(z).add(color);
     buffer.add(minX).add(maxY).add(z).add(color);
     buffer.add(maxX).add(maxY).add(z).add(color);
-    buffer.add(maxX).add(minY).add(z).add(color);
-    buffer.add(minX).add(maxY).add(z).add(color);
 }
 
 Color SpawnTile::getColor() const {
@@ -44,31 +44,33 @@ void SpikeTile::renderEditor(Buffer& buffer, float x, float y, float z) const {
 
 static void addRectangle(Buffer& buffer, float x, float y, float z, float w, float h, Color c) {
     buffer.add(x).add(y).add(z).add(c);
-    buffer.add(x + w).add(y + h).add(z).add(c);
     buffer.add(x + w).add(y).add(z).add(c);
-    buffer.add(x).add(y).add(z).add(c);
-    buffer.add(x + w).add(y + h).add(z).add(c);
     buffer.add(x).add(y + h).add(z).add(c);
+    buffer.add(x + w).add(y + h).add(z).add(c);
 }
 
 void SpikeTile::addSpike(Buffer& buffer, float x, float y, float z, bool left, bool right, bool up,
                          bool down, Color c) {
+    // triangles repeat their last vertex to form a degenerate quad
     constexpr float s = 0.1f;
     constexpr float ss = 0.7f;
     if (left && !up) {
         buffer.add(x + 0.5f - s).add(y).add(z).add(c);
         buffer.add(x).add(y + 0.25f).add(z).add(c);
         buffer.add(x + 0.5f - s).add(y + 0.5f).add(z).add(c);
+        buffer.add(x + 0.5f - s).add(y + 0.5f).add(z).add(c);
         addRectangle(buffer, x + 0.5f - s, y, z, s, 0.5f, c);
     } else if (!left && up) {
         buffer.add(x).add(y + 0.5f - s).add(z).add(c);
         buffer.add(x + 0.25f).add(y).add(z).add(c);
         buffer.add(x + 0.5f).add(y + 0.5f - s).add(z).add(c);
+        buffer.add(x + 0.5f).add(y + 0.5f - s).add(z).add(c);
         addRectangle(buffer, x, y + 0.5f - s, z, 0.5f, s, c);
     } else if (left && up) {
         buffer.add(x).add(y).add(z).add(c);
         buffer.add(x + ss).add(y + 0.5f - s).add(z).add(c);
         buffer.add(x + 0.5f - s).add(y + ss).add(z).add(c);
+        buffer.add(x + 0.5f - s).add(y + ss).add(z).add(c);
     } else {
         addRectangle(buffer, x, y, z, 0.5f, 0.5f, c);
     }
@@ -77,16 +79,19 @@ void SpikeTile::addSpike(Buffer& buffer, float x, float y, float z, bool left, b
         buffer.add(x + 0.5f + s).add(y).add(z).add(c);
         buffer.add(x + 1.0f).add(y + 0.25f).add(z).add(c);
         buffer.add(x + 0.5f + s).add(y + 0.5f).add(z).add(c);
+        buffer.add(x + 0.5f + s).add(y + 0.5f).add(z).add(c);
         addRectangle(buffer, x + 0.5f, y, z, s, 0.5f, c);
     } else if (!right && up) {
         buffer.add(x + 0.5f).add(y + 0.5f - s).add(z).add(c);
         buffer.add(x + 0.75f).add(y).add(z).add(c);
         buffer.add(x + 1.0f).add(y + 0.5f - s).add(z).add(c);
+        buffer.add(x + 1.0f).add(y + 0.5f - s).add(z).add(c);
         addRectangle(buffer, x + 0.5f, y + 0.5f - s, z, 0.5f, s, c);
     } else if (right && up) {
         buffer.add(x + 1.0f).add(y).add(z).add(c);
         buffer.add(x + 1.0f - ss).add(y + 0.5f - s).add(z).add(c);
         buffer.add(x + 0.5f + s).add(y + ss).add(z).add(c);
+        buffer.add(x + 0.5f + s).add(y + ss).add(z).add(c);
     } else {
         addRectangle(buffer, x + 0.5f, y, z, 0.5f, 0.5f, c);
     }
@@ -95,16 +100,19 @@ void SpikeTile::addSpike(Buffer& buffer, float x, float y, float z, bool left, b
         buffer.add(x + 0.5f - s).add(y + 0.5f).add(z).add(c);
         buffer.add(x).add(y + 0.75f).add(z).add(c);
         buffer.add(x + 0.5f - s).add(y + 1.0f).add(z).add(c);
+        buffer.add(x + 0.5f - s).add(y + 1.0f).add(z).add(c);
         addRectangle(buffer, x + 0.5f - s, y + 0.5f, z, s, 0.5f, c);
     } else if (!left && down) {
         buffer.add(x).add(y + 0.5f + s).add(z).add(c);
         buffer.add(x + 0.25f).add(y + 1.0f).add(z).add(c);
         buffer.add(x + 0.5f).add(y + 0.5f + s).add(z).add(c);
+        buffer.add(x + 0.5f).add(y + 0.5f + s).add(z).add(c);
         addRectangle(buffer, x, y + 0.5f, z, 0.5f, s, c);
     } else if (left && down) {
         buffer.add(x).add(y + 1.0f).add(z).add(c);
         buffer.add(x + 0.5f - s).add(y + 1.0f - ss).add(z).add(c);
         buffer.add(x + ss).add(y + 0.5f + s).add(z).add(c);
+        buffer.add(x + ss).add(y + 0.5f + s).add(z).add(c);
     } else {
         addRectangle(buffer, x, y + 0.5f, z, 0.5f, 0.5f, c);
     }
@@ -113,16 +121,19 @@ void SpikeTile::addSpike(Buffer& buffer, float x, float y, float z, bool left, b
         buffer.add(x + 0.5f + s).add(y + 0.5f).add(z).add(c);
         buffer.add(x + 1.0f).add(y + 0.75f).add(z).add(c);
         buffer.add(x + 0.5f + s).add(y + 1.0f).add(z).add(c);
+        buffer.add(x + 0.5f + s).add(y + 1.0f).add(z).add(c);
         addRectangle(buffer, x + 0.5f, y + 0.5f, z, s, 0.5f, c);
     } else if (!right && down) {
         buffer.add(x + 0.5f).add(y + 0.5f + s).add(z).add(c);
         buffer.add(x + 0.75f).add(y + 1.0f).add(z).add(c);
         buffer.add(x + 1.0f).add(y + 0.5f + s).add(z).add(c);
+        buffer.add(x + 1.0f).add(y + 0.5f + s).add(z).add(c);
         addRectangle(buffer, x + 0.5f, y + 0.5f, z, 0.5f, s, c);
     } else if (right && down) {
         buffer.add(x + 1.0f).add(y + 1.0f).add(z).add(c);
         buffer.add(x + 0.5f - s).add(y + ss).add(z).add(c);
         buffer.add(x + 0.5f + s).add(y + 1.0f - ss).add(z).add(c);
+        buffer.add(x + 0.5f + s).add(y + 1.0f - ss).add(z).add(c);
     } else {
         addRectangle(buffer, x + 0.5f, y + 0.5f, z, 0.5f, 0.5f, c);
     }
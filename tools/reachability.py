@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+
+# runs the reachability search on all campaign maps one after another, each search already spreads
+# its steps over all cores
+# usage: tools/reachability.py [path to reachability binary] [map names...]
+
+import glob
+import os
+import subprocess
+import sys
+
+REACHABLE = 0
+UNREACHABLE = 2
+INCONCLUSIVE = 3
+
+binary = sys.argv[1] if len(sys.argv) > 1 else "build/reachability"
+maps = sys.argv[2:]
+if not maps:
+    maps = sorted(os.path.basename(path)[:-5] for path in glob.glob("assets/maps/map*.cmtm"))
+
+def run(name):
+    result = subprocess.run([binary, name], capture_output=True, text=True)
+    lines = result.stdout.strip().splitlines()
+    return (name, result.returncode, lines[-1] if lines else result.stderr.strip())
+
+results = [run(name) for name in maps]
+
+failed = False
+for (name, code, line) in results:
+    if code == REACHABLE:
+        print(line)
+    elif code == INCONCLUSIVE:
+        print(f"INCONCLUSIVE {line}")
+    elif code == UNREACHABLE:
+        print(f"UNBEATABLE {line}")
+        failed = True
+    else:
+        print(f"ERROR {name}: {line}")
+        failed = True
+
+print(f"Checked {len(results)} maps")
+sys.exit(1 if failed else 0)